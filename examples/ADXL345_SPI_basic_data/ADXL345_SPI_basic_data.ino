@@ -28,6 +28,9 @@ ADXL345_WE myAcc = ADXL345_WE(CS_PIN, spi);
 void setup(){
   Serial.begin(9600);
   Serial.println("ADXL345_Sketch - Basic Data");
+/* The SPI clock is 5 MHz by default, which is the maximum of the ADXL345. You can reduce it
+   if necessary (e.g. long wires). Call setSPIClockSpeed() before init(). */
+  // myAcc.setSPIClockSpeed(1000000);
   if(!myAcc.init()){
     Serial.println("ADXL345 not connected!");
   }
@@ -29,6 +29,10 @@ void setup(){
   if(!myAcc.init()){
     Serial.println("ADXL345 not connected!");
   }
+
+/* The I2C clock is 100 kHz by default. The ADXL345 supports up to 400 kHz (fast mode). 
+   Please note that the clock applies to all devices on the bus. */
+  // myAcc.setI2CClockSpeed(400000);
    
 /* Choose the data rate         Hz
     ADXL345_DATA_RATE_3200    3200
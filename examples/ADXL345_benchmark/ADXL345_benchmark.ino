@@ -0,0 +1,123 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch measures the calculation time of the functions delivering
+* results. The register access functions of ADXL345_WE are virtual, so the
+* sketch runs the library against ADXL345_RegisterImage, which answers all
+* reads from a register image in memory. This way, the bus communication,
+* which would dominate and scatter the timings, is not included, and no
+* sensor is needed. convertRawToGValues() is called with a block of 32
+* samples (a full FIFO), its time is given per sample. The results are
+* printed as CSV lines:
+*
+*   function,calc_us,baseline_us,status
+*
+* If you enter your own baseline values (calc_us of a previous run) into
+* baseline[], every function that exceeds its baseline by more than
+* MAX_DEVIATION_PERCENT is marked as REGRESSION and the run ends with FAIL.
+* A baseline of 0 means no check. The size of an ADXL345_WE object (RAM per
+* sensor) is printed additionally.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<ADXL345_WE.h>
+#include<ADXL345_RegisterImage.h>
+#define NUMBER_OF_CALLS 500
+#define MAX_DEVIATION_PERCENT 10.0
+#define BLOCK_SAMPLES 32  // FIFO size
+#define CONVERT_BLOCK 3   // index of convertRawToGValues in functionName[]
+
+ADXL345_RegisterImage myAcc = ADXL345_RegisterImage();
+
+/* The angle functions are not available with ADXL345_NO_ANGLES, so they come last */
+const char *functionName[] = {
+  "getCorrectedRawValues", "getRawValues", "getGValues",
+  "convertRawToGValues_per_sample", "getRawPerG",
+#ifndef ADXL345_NO_ANGLES
+  "getAngles", "getCorrAngles", "getPitch", "getRoll", "getOrientation"
+#endif
+};
+const int numberOfFunctions = sizeof(functionName) / sizeof(functionName[0]);
+
+float baseline[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}; // calc_us of a reference run, order as functionName[]
+
+int16_t blockXYZ[3*BLOCK_SAMPLES];  // x0,y0,z0,x1,... as from getFifoRawValues()
+float gx[BLOCK_SAMPLES];
+float gy[BLOCK_SAMPLES];
+float gz[BLOCK_SAMPLES];
+
+volatile float dummy = 0.0; // prevents the compiler from removing the calls
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("ADXL345_Sketch - Benchmark");
+  Serial.println();
+  myAcc.init();
+  myAcc.setRawValues(30, -20, 240); // fixed data for all calls
+  myAcc.setDataRate(ADXL345_DATA_RATE_3200);
+  myAcc.setCorrFactors(-266.0, 285.0, -268.0, 278.0, -291.0, 214.0);
+  for(int i=0; i<BLOCK_SAMPLES; i++){
+    blockXYZ[3*i] = 30 + i;
+    blockXYZ[3*i + 1] = -20 - i;
+    blockXYZ[3*i + 2] = 240 + (i % 8);
+  }
+#ifndef ADXL345_NO_ANGLES
+  myAcc.measureAngleOffsets();
+#endif
+
+  bool passed = true;
+  Serial.println("function,calc_us,baseline_us,status");
+  for(int i=0; i<numberOfFunctions; i++){
+    float calcTime = timePerCall(i);
+    const char *status = "OK";
+    if((baseline[i] > 0) && (calcTime > baseline[i] * (1.0 + MAX_DEVIATION_PERCENT / 100.0))){
+      status = "REGRESSION";
+      passed = false;
+    }
+    Serial.print(functionName[i]);
+    Serial.print(",");
+    Serial.print(calcTime, 2);
+    Serial.print(",");
+    Serial.print(baseline[i], 2);
+    Serial.print(",");
+    Serial.println(status);
+  }
+  Serial.print("object_size_bytes,");
+  Serial.println(sizeof(ADXL345_WE));
+  Serial.println(passed ? "PASS" : "FAIL");
+}
+
+void loop() {
+}
+
+float timePerCall(int function){
+  unsigned long start = micros();
+  for(int i=0; i<NUMBER_OF_CALLS; i++){
+    switch(function){
+      case 0: dummy = myAcc.getCorrectedRawValues().x; break;
+      case 1: dummy = myAcc.getRawValues().x;          break;
+      case 2: dummy = myAcc.getGValues().x;            break;
+      case 3:
+        myAcc.convertRawToGValues(blockXYZ, gx, gy, gz, BLOCK_SAMPLES);
+        dummy = gz[BLOCK_SAMPLES - 1];
+        break;
+      case 4: dummy = myAcc.getRawPerG().x;            break;
+#ifndef ADXL345_NO_ANGLES
+      case 5: dummy = myAcc.getAngles().x;             break;
+      case 6: dummy = myAcc.getCorrAngles().x;         break;
+      case 7: dummy = myAcc.getPitch();                break;
+      case 8: dummy = myAcc.getRoll();                 break;
+      case 9: dummy = myAcc.getOrientation();          break;
+#endif
+    }
+  }
+  float callTime = (micros() - start) / (float)NUMBER_OF_CALLS;
+  if(function == CONVERT_BLOCK){
+    callTime /= BLOCK_SAMPLES;  // one call converts a full FIFO block
+  }
+  return callTime;
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to save the complete configuration (registers,
+* calibration, angle offsets) as a profile in the EEPROM and how to restore
+* it at the next start instead of calling init() and all setters again.
+* restoreConfigProfile() only writes to the ADXL345 if its registers differ
+* from the profile, e.g. after a power loss of the sensor.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<EEPROM.h>
+#include<ADXL345_WE.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define PROFILE_EEPROM_ADDR 0
+
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+
+void setup() {
+  Wire.begin();
+  Serial.begin(9600);
+  Serial.println("ADXL345_Sketch - Configuration Profile");
+  Serial.println();
+
+  adxl345_profile profile;
+  EEPROM.get(PROFILE_EEPROM_ADDR, profile);
+
+/* restoreConfigProfile() returns false if there is no valid profile (wrong version or
+   CRC, e.g. empty or partly written EEPROM) or if the ADXL345 does not accept it */
+  unsigned long start = micros();
+  if(myAcc.restoreConfigProfile(&profile)){
+    Serial.print("Profile restored in [us]: ");
+    Serial.println(micros() - start);
+  }
+  else{
+    Serial.println("No valid profile - full configuration");
+    start = micros();
+    if (!myAcc.init()) {
+      Serial.println("ADXL345 not connected!");
+    }
+    myAcc.setCorrFactors(-266.0, 285.0, -268.0, 278.0, -291.0, 214.0);
+    myAcc.setDataRate(ADXL345_DATA_RATE_50);
+    myAcc.setRange(ADXL345_RANGE_4G);
+    myAcc.setActivityParameters(ADXL345_DC_MODE, ADXL345_XYZ, 0.5);
+    myAcc.setInactivityParameters(ADXL345_DC_MODE, ADXL345_XYZ, 0.5, 10);
+    myAcc.setInterrupt(ADXL345_ACTIVITY, INT_PIN_2);
+    myAcc.setInterrupt(ADXL345_INACTIVITY, INT_PIN_2);
+    myAcc.measureAngleOffsets();
+    Serial.print("Full configuration in [us]: ");
+    Serial.println(micros() - start);
+
+/* getConfigProfile() reads the registers (without clearing pending interrupts) and takes the
+   calibration data. It returns false if the registers can't be read. */
+    if(myAcc.getConfigProfile(&profile)){
+      EEPROM.put(PROFILE_EEPROM_ADDR, profile);
+      Serial.println("Profile saved");
+    }
+    else{
+      Serial.println("Profile could not be read");
+    }
+  }
+  Serial.print("g-Range: ");
+  Serial.println(myAcc.getRangeAsString());
+  Serial.println();
+}
+
+void loop() {
+  xyzFloat corrAngles = myAcc.getCorrAngles();
+  Serial.print("Angle x = ");
+  Serial.print(corrAngles.x);
+  Serial.print("  |  Angle y = ");
+  Serial.print(corrAngles.y);
+  Serial.print("  |  Angle z = ");
+  Serial.println(corrAngles.z);
+  delay(1000);
+}
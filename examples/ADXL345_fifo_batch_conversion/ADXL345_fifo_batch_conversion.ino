@@ -0,0 +1,124 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to read the complete FIFO as raw values and how to
+* convert them into g values in one go with convertRawToGValues(). The
+* conversion time is compared with a sample by sample conversion.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define FIFO_SAMPLES 32
+const int int2Pin = 2;
+volatile bool event = false;
+
+int16_t rawXYZ[3*FIFO_SAMPLES]; // x0, y0, z0, x1, y1, z1, ...
+float gx[FIFO_SAMPLES];
+float gy[FIFO_SAMPLES];
+float gz[FIFO_SAMPLES];
+float gzSingle[FIFO_SAMPLES];
+
+/* Insert your data from ADXL345_calibration.ino: xMin, xMax, yMin, yMax, zMin, zMax */
+const float calib[6] = {-266.0, 285.0, -268.0, 278.0, -291.0, 214.0};
+xyzFloat offset;   // same as calculated by setCorrFactors()
+xyzFloat corrFact; // same as calculated by setCorrFactors()
+const float rangeFactor = 1.0; // full resolution
+
+/* There are several ways to create your ADXL345 object:
+ * ADXL345_WE myAcc = ADXL345_WE()                -> uses Wire / I2C Address = 0x53
+ * ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR) -> uses Wire / ADXL345_I2CADDR
+ * ADXL345_WE myAcc = ADXL345_WE(&wire2)          -> uses the TwoWire object wire2 / ADXL345_I2CADDR
+ * ADXL345_WE myAcc = ADXL345_WE(&wire2, ADXL345_I2CADDR) -> all together
+ */
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+
+void setup() {
+  Wire.begin();
+  Serial.begin(9600);
+  pinMode(int2Pin, INPUT);
+  Serial.println("ADXL345_Sketch - FIFO - Batch Conversion");
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("ADXL345 not connected!");
+  }
+
+  myAcc.setCorrFactors(calib[0], calib[1], calib[2], calib[3], calib[4], calib[5]);
+  corrFact.x = UNITS_PER_G / (0.5 * (calib[1] - calib[0]));
+  corrFact.y = UNITS_PER_G / (0.5 * (calib[3] - calib[2]));
+  corrFact.z = UNITS_PER_G / (0.5 * (calib[5] - calib[4]));
+  offset.x = (calib[1] + calib[0]) * 0.5;
+  offset.y = (calib[3] + calib[2]) * 0.5;
+  offset.z = (calib[5] + calib[4]) * 0.5;
+
+  myAcc.setDataRate(ADXL345_DATA_RATE_800);
+  myAcc.setRange(ADXL345_RANGE_4G);
+
+  attachInterrupt(digitalPinToInterrupt(int2Pin), eventISR, RISING);
+  myAcc.setInterrupt(ADXL345_WATERMARK, INT_PIN_2); // Interrupt when FIFO is full
+  myAcc.setFifoParameters(ADXL345_TRIGGER_INT_1, FIFO_SAMPLES);
+  myAcc.setFifoMode(ADXL345_FIFO);
+}
+
+void loop() {
+  event = false;
+  myAcc.readAndClearInterrupts();
+  myAcc.setMeasureMode(true);
+  while(!event){}  // FIFO is full
+  myAcc.setMeasureMode(false);
+
+/* getFifoRawValues(rawXYZ, samples) reads the FIFO into an array of interleaved x,y,z raw values */
+  myAcc.getFifoRawValues(rawXYZ, FIFO_SAMPLES);
+
+  unsigned long start = micros();
+  convertSampleBySample();
+  unsigned long singleTime = micros() - start;
+
+/* convertRawToGValues() applies offsets, range and correction factors to the whole block */
+  start = micros();
+  myAcc.convertRawToGValues(rawXYZ, gx, gy, gz, FIFO_SAMPLES);
+  unsigned long batchTime = micros() - start;
+
+  for(int i=0; i<FIFO_SAMPLES; i++){
+    Serial.print("g-x   = ");
+    Serial.print(gx[i]);
+    Serial.print("  |  g-y   = ");
+    Serial.print(gy[i]);
+    Serial.print("  |  g-z   = ");
+    Serial.println(gz[i]);
+  }
+
+  float maxDiff = 0.0;
+  for(int i=0; i<FIFO_SAMPLES; i++){
+    maxDiff = max(maxDiff, (float)fabs(gz[i] - gzSingle[i]));
+  }
+  Serial.print("Max. difference of both methods [g]:     ");
+  Serial.println(maxDiff, 6);
+  Serial.print("Batch conversion [samples/s]:            ");
+  Serial.println(FIFO_SAMPLES * 1000000.0 / batchTime);
+  Serial.print("Sample by sample conversion [samples/s]: ");
+  Serial.println(FIFO_SAMPLES * 1000000.0 / singleTime);
+  Serial.println();
+  delay(2000);
+}
+
+void eventISR() {
+  event = true;
+}
+
+/* The calculation getCorrectedRawValues() and getGValues() do for every single sample */
+void convertSampleBySample(){
+  for(int i=0; i<FIFO_SAMPLES; i++){
+    float xRaw = rawXYZ[3*i] - (offset.x / rangeFactor);
+    float yRaw = rawXYZ[3*i + 1] - (offset.y / rangeFactor);
+    float zRaw = rawXYZ[3*i + 2] - (offset.z / rangeFactor);
+    gx[i] = xRaw * MILLI_G_PER_LSB * rangeFactor * corrFact.x / 1000.0;
+    gy[i] = yRaw * MILLI_G_PER_LSB * rangeFactor * corrFact.y / 1000.0;
+    gzSingle[i] = zRaw * MILLI_G_PER_LSB * rangeFactor * corrFact.z / 1000.0;
+  }
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to reduce the amount of data with the
+* ADXL345_DeadbandFilter (report by exception). Only samples which differ
+* from the last output by more than the dead band, or which are due because
+* of the heartbeat, are printed. Leave the ADXL345 lying still and move it
+* from time to time to see the effect.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#include<ADXL345_DeadbandFilter.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define FIFO_SAMPLES 25
+const int int2Pin = 2;
+volatile bool event = false;
+
+int16_t rawXYZ[3*32];
+
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+ADXL345_DeadbandFilter myFilter = ADXL345_DeadbandFilter();
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  pinMode(int2Pin, INPUT);
+  Serial.println("ADXL345_Sketch - FIFO - Dead Band Filter");
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("ADXL345 not connected!");
+  }
+
+/* Insert your data from ADXL345_calibration.ino and uncomment for more precise results */
+  // myAcc.setCorrFactors(-266.0, 285.0, -268.0, 278.0, -291.0, 214.0);
+
+  myAcc.setDataRate(ADXL345_DATA_RATE_100);
+  myAcc.setRange(ADXL345_RANGE_2G);
+
+/* Dead bands in g for x, y and z. Set them after range and correction factors, because
+   they are converted into raw values with the current settings. */
+  myFilter.setDeadband(&myAcc, 0.05, 0.05, 0.05);
+/* Pass on one sample at least every 500 samples (here: 5 seconds), 0 = no heartbeat */
+  myFilter.setHeartbeat(500);
+
+  attachInterrupt(digitalPinToInterrupt(int2Pin), eventISR, RISING);
+  myAcc.setInterrupt(ADXL345_WATERMARK, INT_PIN_2);
+  myAcc.setFifoParameters(ADXL345_TRIGGER_INT_1, FIFO_SAMPLES);
+  myAcc.setFifoMode(ADXL345_STREAM);
+  myAcc.readAndClearInterrupts();
+}
+
+void loop() {
+  if(event){
+    event = false;
+    uint8_t samples = myAcc.drainFifo(rawXYZ, 32, NULL);
+/* filterBlock() keeps only the samples to be passed on and returns their number */
+    uint8_t outputSamples = myFilter.filterBlock(rawXYZ, samples);
+    for(int i=0; i<outputSamples; i++){
+      Serial.print("raw-x = ");
+      Serial.print(rawXYZ[3*i]);
+      Serial.print("  |  raw-y = ");
+      Serial.print(rawXYZ[3*i + 1]);
+      Serial.print("  |  raw-z = ");
+      Serial.println(rawXYZ[3*i + 2]);
+    }
+    if(myFilter.getNumberOfInputSamples() >= 1000){
+      Serial.print("Compression ratio: ");
+      Serial.println(myFilter.getCompressionRatio());
+      myFilter.reset();
+    }
+  }
+}
+
+void eventISR() {
+  event = true;
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to service two ADXL345 from one loop without polling
+* the sensors. Each sensor raises a watermark interrupt when its FIFO holds
+* the defined number of samples. Only then drainFifo() reads INT_SOURCE and
+* empties the FIFO.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#define FIFO_SAMPLES 16
+const int int2PinAccA = 2;
+const int int2PinAccB = 3;
+volatile bool eventAccA = false;
+volatile bool eventAccB = false;
+
+int16_t rawXYZ[3*32];
+
+ADXL345_WE accA = ADXL345_WE(0x53); // SDO = LOW
+ADXL345_WE accB = ADXL345_WE(0x1D); // SDO = HIGH
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  pinMode(int2PinAccA, INPUT);
+  pinMode(int2PinAccB, INPUT);
+  Serial.println("ADXL345_Sketch - FIFO - Interrupt driven drain of two sensors");
+  Serial.println();
+  setupAcc(accA, "A");
+  setupAcc(accB, "B");
+  attachInterrupt(digitalPinToInterrupt(int2PinAccA), eventAccAISR, RISING);
+  attachInterrupt(digitalPinToInterrupt(int2PinAccB), eventAccBISR, RISING);
+  accA.readAndClearInterrupts();
+  accB.readAndClearInterrupts();
+}
+
+void loop() {
+  if(eventAccA){
+    eventAccA = false;
+    serviceAcc(accA, "A");
+  }
+  if(eventAccB){
+    eventAccB = false;
+    serviceAcc(accB, "B");
+  }
+}
+
+void setupAcc(ADXL345_WE &acc, const char *name){
+  if (!acc.init()) {
+    Serial.print("ADXL345 ");
+    Serial.print(name);
+    Serial.println(" not connected!");
+  }
+  acc.setDataRate(ADXL345_DATA_RATE_50);
+  acc.setRange(ADXL345_RANGE_2G);
+  acc.setInterrupt(ADXL345_WATERMARK, INT_PIN_2);
+  acc.setFifoParameters(ADXL345_TRIGGER_INT_1, FIFO_SAMPLES);
+  acc.setFifoMode(ADXL345_STREAM);
+}
+
+/* drainFifo(rawXYZ, maxSamples, &intSource) returns the number of x,y,z triples read */
+void serviceAcc(ADXL345_WE &acc, const char *name){
+  byte intSource = 0;
+  uint8_t samples = acc.drainFifo(rawXYZ, 32, &intSource);
+  if(acc.checkInterrupt(intSource, ADXL345_OVERRUN)){
+    Serial.print("Overrun! ");
+  }
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(samples);
+  Serial.print(" samples, last raw x,y,z = ");
+  if(samples > 0){
+    Serial.print(rawXYZ[3*(samples-1)]);
+    Serial.print(", ");
+    Serial.print(rawXYZ[3*(samples-1) + 1]);
+    Serial.print(", ");
+    Serial.print(rawXYZ[3*(samples-1) + 2]);
+  }
+  Serial.println();
+}
+
+void eventAccAISR() {
+  eventAccA = true;
+}
+
+void eventAccBISR() {
+  eventAccB = true;
+}
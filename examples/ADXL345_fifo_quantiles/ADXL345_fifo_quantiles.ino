@@ -0,0 +1,87 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to collect the distribution of the acceleration
+* amounts per axis with ADXL345_QuantileSketch and how to print quantiles.
+* The sketch needs about 2 KB of RAM (or 1 KB with ADXL345_QUANTILE_SUB_BITS
+* set to 3 in ADXL345_QuantileSketch.h), so please use a board like ESP32,
+* Arduino Mega, Nano 33 IoT, etc.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#include<ADXL345_QuantileSketch.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define FIFO_SAMPLES 25
+const int int2Pin = 2;
+volatile bool event = false;
+
+int16_t rawXYZ[3*32];
+
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+ADXL345_QuantileSketch mySketch = ADXL345_QuantileSketch();
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  pinMode(int2Pin, INPUT);
+  Serial.println("ADXL345_Sketch - FIFO - Quantiles");
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("ADXL345 not connected!");
+  }
+  myAcc.setI2CClockSpeed(400000);
+  myAcc.setDataRate(ADXL345_DATA_RATE_800);
+  myAcc.setRange(ADXL345_RANGE_4G);
+/* Insert your data from ADXL345_calibration.ino and uncomment for more precise results */
+  // myAcc.setCorrFactors(-266.0, 285.0, -268.0, 278.0, -291.0, 214.0);
+/* The offsets are subtracted before the amounts are counted. Call setOffsets() after
+   setRange() and setCorrFactors(). */
+  mySketch.setOffsets(&myAcc);
+
+  attachInterrupt(digitalPinToInterrupt(int2Pin), eventISR, RISING);
+  myAcc.setInterrupt(ADXL345_WATERMARK, INT_PIN_2);
+  myAcc.setFifoParameters(ADXL345_TRIGGER_INT_1, FIFO_SAMPLES);
+  myAcc.setFifoMode(ADXL345_STREAM);
+  myAcc.readAndClearInterrupts();
+}
+
+void loop() {
+  if(event){
+    event = false;
+    uint8_t samples = myAcc.drainFifo(rawXYZ, 32, NULL);
+    mySketch.addBlock(rawXYZ, samples);
+  }
+
+/* Every 8000 samples (10 seconds) the quantiles are printed. You could also merge the
+   sketch into another one with merge() to get the distribution of longer periods. */
+  if(mySketch.getCount() >= 8000){
+    printQuantile("p50   ", 0.5);
+    printQuantile("p95   ", 0.95);
+    printQuantile("p99   ", 0.99);
+    printQuantile("p99.9 ", 0.999);
+    Serial.println();
+    mySketch.reset();
+  }
+}
+
+void eventISR() {
+  event = true;
+}
+
+/* getQuantile(&myAcc, q) returns the quantiles of |x|, |y|, |z| in g */
+void printQuantile(const char *name, float q){
+  xyzFloat g = mySketch.getQuantile(&myAcc, q);
+  Serial.print(name);
+  Serial.print("|g-x| = ");
+  Serial.print(g.x);
+  Serial.print("  |  |g-y| = ");
+  Serial.print(g.y);
+  Serial.print("  |  |g-z| = ");
+  Serial.println(g.z);
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to detect shocks in the FIFO data with the
+* ADXL345_ShockDetector. Other than the tap and activity interrupts, the
+* detector reports the peak acceleration (interpolated between the samples),
+* the duration and the energy of every shock. Additionally, the sketch prints
+* how long the processing of a FIFO block takes.
+*
+* At 1600 Hz, I2C with 400 kHz is sufficient. For 3200 Hz please use SPI
+* (see ADXL345_SPI_basic_data.ino).
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#include<ADXL345_ShockDetector.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define FIFO_SAMPLES 16
+const int int2Pin = 2;
+volatile bool event = false;
+volatile bool shockDetected = false;
+
+int16_t rawXYZ[3*32];
+unsigned long maxProcessingTime = 0;
+
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+ADXL345_ShockDetector myDetector = ADXL345_ShockDetector();
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  pinMode(int2Pin, INPUT);
+  Serial.println("ADXL345_Sketch - FIFO - Shock Detector");
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("ADXL345 not connected!");
+  }
+  myAcc.setI2CClockSpeed(400000);
+  myAcc.setDataRate(ADXL345_DATA_RATE_1600);
+  myAcc.setRange(ADXL345_RANGE_16G);
+
+/* Threshold in g (deviation from the static acceleration). Set it after range and correction
+   factors, because it is converted into raw values with the current settings. */
+  myDetector.setThreshold(&myAcc, 2.0);
+/* A deviation lasting longer than the maximum duration (in samples, 128 = 80 ms at 1600 Hz) is
+   not reported as a shock, it becomes the new static level, e.g. after a change of the orientation */
+  myDetector.setMaxDuration(128);
+/* The handler is called at the end of every shock */
+  myDetector.setShockHandler(onShock);
+
+  attachInterrupt(digitalPinToInterrupt(int2Pin), eventISR, RISING);
+  myAcc.setInterrupt(ADXL345_WATERMARK, INT_PIN_2);
+  myAcc.setFifoParameters(ADXL345_TRIGGER_INT_1, FIFO_SAMPLES);
+  myAcc.setFifoMode(ADXL345_STREAM);
+  myAcc.readAndClearInterrupts();
+  Serial.println("Knock on the table or hit the ADXL345 gently");
+}
+
+void loop() {
+  if(event){
+    event = false;
+    uint8_t samples = myAcc.drainFifo(rawXYZ, 32, NULL);
+    unsigned long start = micros();
+    myDetector.processBlock(rawXYZ, samples);
+    unsigned long processingTime = micros() - start;
+    if(processingTime > maxProcessingTime){
+      maxProcessingTime = processingTime;
+    }
+  }
+  if(shockDetected){
+    shockDetected = false;
+    adxl345_shockEvent shock = myDetector.getLastShock();
+    Serial.print("Shock at sample ");
+    Serial.print(shock.start);
+    Serial.print(", duration [samples]: ");
+    Serial.println(shock.duration);
+    Serial.print("Peak [g]:         x = ");
+    Serial.print(shock.peak.x);
+    Serial.print("  |  y = ");
+    Serial.print(shock.peak.y);
+    Serial.print("  |  z = ");
+    Serial.println(shock.peak.z);
+    Serial.print("Energy [g^2*ms]:  x = ");
+    Serial.print(shock.energy.x / 1.6);
+    Serial.print("  |  y = ");
+    Serial.print(shock.energy.y / 1.6);
+    Serial.print("  |  z = ");
+    Serial.println(shock.energy.z / 1.6);
+    Serial.print("Max. processing time per block [us]: ");
+    Serial.println(maxProcessingTime);
+    Serial.println();
+  }
+}
+
+void eventISR() {
+  event = true;
+}
+
+/* Keep the handler short, printing is done in the main loop */
+void onShock(const adxl345_shockEvent *shock){
+  shockDetected = true;
+}
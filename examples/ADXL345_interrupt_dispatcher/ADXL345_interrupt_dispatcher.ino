@@ -0,0 +1,95 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch shows how to use the interrupt dispatcher. A handler function
+* is registered for each interrupt type of interest. dispatchInterrupts()
+* reads ACT_TAP_STATUS and INT_SOURCE in one go and calls the handlers of
+* all pending interrupts. This saves the separate calls of
+* readAndClearInterrupts(), checkInterrupt() and getActTapStatus().
+*
+* The dispatcher is optional: uncomment #define ADXL345_USE_INT_HANDLERS in
+* ADXL345_WE.h (or define it as build flag) to use this sketch.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#ifndef ADXL345_USE_INT_HANDLERS
+#error "Please uncomment #define ADXL345_USE_INT_HANDLERS in ADXL345_WE.h"
+#endif
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+const int int2Pin = 2;
+volatile bool event = false;
+
+ADXL345_WE myAcc = ADXL345_WE(ADXL345_I2CADDR);
+
+void setup() {
+  Wire.begin();
+  Serial.begin(9600);
+  pinMode(int2Pin, INPUT);
+  Serial.println("ADXL345_Sketch - Interrupt Dispatcher");
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("ADXL345 not connected!");
+  }
+
+  myAcc.setDataRate(ADXL345_DATA_RATE_200);
+  myAcc.setRange(ADXL345_RANGE_8G);
+
+  attachInterrupt(digitalPinToInterrupt(int2Pin), eventISR, RISING);
+
+  myAcc.setGeneralTapParameters(ADXL345_XYZ, 3.0, 30, 100.0);
+  myAcc.setActivityParameters(ADXL345_DC_MODE, ADXL345_XYZ, 1.5);
+  myAcc.setFreeFallThresholds(0.4, 100);
+
+/* setInterruptHandler(type, handler, context) registers a handler, NULL removes it. The
+   handler gets the content of INT_SOURCE and ACT_TAP_STATUS, and the context pointer. Here
+   the context is the sensor object, so the tap handler can read the current values. */
+  myAcc.setInterruptHandler(ADXL345_SINGLE_TAP, onTap, &myAcc);
+  myAcc.setInterruptHandler(ADXL345_ACTIVITY, onActivity, &myAcc);
+  myAcc.setInterruptHandler(ADXL345_FREEFALL, onFreeFall);
+
+  myAcc.setInterrupt(ADXL345_SINGLE_TAP, INT_PIN_2);
+  myAcc.setInterrupt(ADXL345_ACTIVITY, INT_PIN_2);
+  myAcc.setInterrupt(ADXL345_FREEFALL, INT_PIN_2);
+  myAcc.readAndClearInterrupts();
+}
+
+void loop() {
+  if(event){
+    event = false;
+    myAcc.dispatchInterrupts();
+  }
+}
+
+void eventISR() {
+  event = true;
+}
+
+void onTap(uint8_t intSource, uint8_t actTapStatus, void *context){
+  ADXL345_WE *acc = (ADXL345_WE*)context;
+  Serial.print("TAP at: ");
+  printAxes(actTapStatus, ADXL345_TAP_X, ADXL345_TAP_Y, ADXL345_TAP_Z);
+  Serial.print("Orientation: ");
+  Serial.println(acc->getOrientationAsString());
+}
+
+void onActivity(uint8_t intSource, uint8_t actTapStatus, void *context){
+  Serial.print("ACT at: ");
+  printAxes(actTapStatus, ADXL345_ACT_X, ADXL345_ACT_Y, ADXL345_ACT_Z);
+}
+
+void onFreeFall(uint8_t intSource, uint8_t actTapStatus, void *context){
+  Serial.println("FREEFALL");
+}
+
+void printAxes(uint8_t actTapStatus, adxl345_actTap x, adxl345_actTap y, adxl345_actTap z){
+  if(actTapStatus & (1<<x)) { Serial.print("X "); }
+  if(actTapStatus & (1<<y)) { Serial.print("Y "); }
+  if(actTapStatus & (1<<z)) { Serial.print("Z "); }
+  Serial.println();
+}
@@ -0,0 +1,234 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch checks the error bound of ADXL345_QuantileSketch without a
+* sensor: every quantile must differ from the exact quantile by at most
+* 2^-(SUB_BITS+1) of the exact value (3.1% for SUB_BITS = 4).
+*
+* 1) Every amount from 0 to 8191 (positive and negative) is added as the
+*    only sample of a sketch. p50 must be within the bound.
+* 2) Several rounds of random data (small and large amounts mixed) are
+*    added. The quantiles p1 ... p100 are compared with the exact quantiles
+*    of the sorted data.
+* 3) The same with the calibration data of setCorrFactors(): the quantiles
+*    in g must match the exact quantiles of |getGValues()|. The offsets are
+*    rounded to raw values, so 0.5 raw is allowed additionally.
+*
+* The sketch needs about 5 KB of RAM, so please use a board like ESP32,
+* Arduino Mega, Nano 33 IoT, etc.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<ADXL345_WE.h>
+#include<ADXL345_RegisterImage.h>
+#include<ADXL345_QuantileSketch.h>
+#define NUMBER_OF_SAMPLES 400
+#define NUMBER_OF_ROUNDS 20
+#define NUMBER_OF_QUANTILES 8
+
+const float maxRelError = 1.0 / (1 << (ADXL345_QUANTILE_SUB_BITS + 1));
+const float quantile[NUMBER_OF_QUANTILES] = {0.01, 0.1, 0.5, 0.9, 0.95, 0.99, 0.999, 1.0};
+
+int16_t rawXYZ[3*NUMBER_OF_SAMPLES];
+uint16_t amount[NUMBER_OF_SAMPLES];
+float maxErrorFound = 0.0;
+
+ADXL345_QuantileSketch mySketch = ADXL345_QuantileSketch();
+ADXL345_RegisterImage myAcc = ADXL345_RegisterImage(); // no sensor needed
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("ADXL345_Sketch - Quantile Bound Check");
+  Serial.println();
+  Serial.print("Allowed relative error: ");
+  Serial.println(maxRelError, 4);
+
+  bool passed = checkAllAmounts();
+  Serial.print("Amounts 0...8191: ");
+  Serial.println(passed ? "OK" : "FAILED");
+
+  randomSeed(345);
+  bool randomPassed = true;
+  for(int round=0; round<NUMBER_OF_ROUNDS; round++){
+    randomPassed &= checkRandomData();
+  }
+  Serial.print("Random data:      ");
+  Serial.println(randomPassed ? "OK" : "FAILED");
+
+  myAcc.init();
+  myAcc.setRange(ADXL345_RANGE_16G);
+  myAcc.setCorrFactors(-266.0, 285.0, -268.0, 278.0, -291.0, 214.0);
+  mySketch.setOffsets(&myAcc);
+  bool calibratedPassed = checkCalibratedSample(0, 0, 214); // z = +1 g
+  for(int round=0; round<NUMBER_OF_ROUNDS; round++){
+    calibratedPassed &= checkCalibratedData();
+  }
+  Serial.print("Calibrated data:  ");
+  Serial.println(calibratedPassed ? "OK" : "FAILED");
+  randomPassed &= calibratedPassed;
+  Serial.print("Max. relative error found: ");
+  Serial.println(maxErrorFound, 4);
+  Serial.println((passed && randomPassed) ? "PASS" : "FAIL");
+}
+
+void loop() {
+}
+
+/* true if the estimate is within the bound */
+bool withinBound(float estimate, uint16_t exact){
+  float error = fabs(estimate - exact);
+  if(exact > 0){
+    maxErrorFound = max(maxErrorFound, error / exact);
+  }
+  return error <= exact * maxRelError;
+}
+
+bool checkAllAmounts(){
+  bool passed = true;
+  for(int16_t a=0; a<=8191; a++){
+    int16_t sample[3] = {a, (int16_t)(-a), a};
+    mySketch.reset();
+    mySketch.addSample(sample);
+    xyzFloat p50 = mySketch.getRawQuantile(0.5);
+    if(!withinBound(p50.x, a) || !withinBound(p50.y, a)){
+      Serial.print("Amount ");
+      Serial.print(a);
+      Serial.print(" -> ");
+      Serial.println(p50.x);
+      passed = false;
+    }
+  }
+  return passed;
+}
+
+/* Mix of small and large amounts: the exponent is random, too */
+int16_t randomRaw(){
+  long limit = 1L << random(1, 14);
+  return (int16_t)random(-limit + 1, limit);
+}
+
+bool checkRandomData(){
+  bool passed = true;
+  mySketch.reset();
+  for(int i=0; i<3*NUMBER_OF_SAMPLES; i++){
+    rawXYZ[i] = randomRaw();
+  }
+  mySketch.addBlock(rawXYZ, NUMBER_OF_SAMPLES);
+
+  for(int axis=0; axis<3; axis++){
+    for(int i=0; i<NUMBER_OF_SAMPLES; i++){
+      amount[i] = abs(rawXYZ[3*i + axis]);
+    }
+    sortAmounts();
+    for(int j=0; j<NUMBER_OF_QUANTILES; j++){
+      xyzFloat estimate = mySketch.getRawQuantile(quantile[j]);
+      float axisEstimate = (axis == 0) ? estimate.x : ((axis == 1) ? estimate.y : estimate.z);
+      long rank = (long)ceil(quantile[j] * NUMBER_OF_SAMPLES); // same rank as the sketch
+      if(rank < 1){
+        rank = 1;
+      }
+      uint16_t exact = amount[rank - 1];
+      if(!withinBound(axisEstimate, exact)){
+        Serial.print("Axis ");
+        Serial.print(axis);
+        Serial.print(", q = ");
+        Serial.print(quantile[j], 3);
+        Serial.print(": exact = ");
+        Serial.print(exact);
+        Serial.print(", sketch = ");
+        Serial.println(axisEstimate);
+        passed = false;
+      }
+    }
+  }
+  return passed;
+}
+
+/* true if the estimate in g is within the bound (plus 0.5 raw for the rounded offset) */
+bool withinBoundG(float estimate, float exact, float rawPerG){
+  float error = fabs(estimate - exact) - 0.5 / rawPerG;
+  if(exact > 0){
+    maxErrorFound = max(maxErrorFound, error / exact);
+  }
+  return error <= exact * maxRelError;
+}
+
+/* A single sample: p50 must match |getGValues()| */
+bool checkCalibratedSample(int16_t x, int16_t y, int16_t z){
+  myAcc.setRawValues(x, y, z);
+  xyzFloat g = myAcc.getGValues();
+  xyzFloat rawPerG = myAcc.getRawPerG();
+  int16_t sample[3] = {x, y, z};
+  mySketch.reset();
+  mySketch.addSample(sample);
+  xyzFloat p50 = mySketch.getQuantile(&myAcc, 0.5);
+  bool passed = withinBoundG(p50.x, fabs(g.x), rawPerG.x) && withinBoundG(p50.y, fabs(g.y), rawPerG.y)
+    && withinBoundG(p50.z, fabs(g.z), rawPerG.z);
+  if(!passed){
+    Serial.print("Calibrated sample: getGValues().z = ");
+    Serial.print(g.z, 3);
+    Serial.print(", sketch p50 = ");
+    Serial.println(p50.z, 3);
+  }
+  return passed;
+}
+
+/* Random data within the 13 bit range. The exact amounts are stored doubled, because the
+   offsets are multiples of 0.5 raw. */
+bool checkCalibratedData(){
+  bool passed = true;
+  mySketch.reset();
+  for(int i=0; i<3*NUMBER_OF_SAMPLES; i++){
+    rawXYZ[i] = randomRaw() / 2;
+  }
+  mySketch.addBlock(rawXYZ, NUMBER_OF_SAMPLES);
+  xyzFloat rawOffsets = myAcc.getRawOffsets();
+  xyzFloat rawPerG = myAcc.getRawPerG();
+  float offset[3] = {rawOffsets.x, rawOffsets.y, rawOffsets.z};
+  float factor[3] = {rawPerG.x, rawPerG.y, rawPerG.z};
+
+  for(int axis=0; axis<3; axis++){
+    for(int i=0; i<NUMBER_OF_SAMPLES; i++){
+      amount[i] = (uint16_t)round(fabs(2.0 * (rawXYZ[3*i + axis] - offset[axis])));
+    }
+    sortAmounts();
+    for(int j=0; j<NUMBER_OF_QUANTILES; j++){
+      xyzFloat estimate = mySketch.getQuantile(&myAcc, quantile[j]);
+      float axisEstimate = (axis == 0) ? estimate.x : ((axis == 1) ? estimate.y : estimate.z);
+      long rank = (long)ceil(quantile[j] * NUMBER_OF_SAMPLES);
+      if(rank < 1){
+        rank = 1;
+      }
+      float exact = amount[rank - 1] / (2.0 * factor[axis]);
+      if(!withinBoundG(axisEstimate, exact, factor[axis])){
+        Serial.print("Calibrated, axis ");
+        Serial.print(axis);
+        Serial.print(", q = ");
+        Serial.print(quantile[j], 3);
+        Serial.print(": exact = ");
+        Serial.print(exact, 4);
+        Serial.print(" g, sketch = ");
+        Serial.println(axisEstimate, 4);
+        passed = false;
+      }
+    }
+  }
+  return passed;
+}
+
+/* Insertion sort, ascending */
+void sortAmounts(){
+  for(int i=1; i<NUMBER_OF_SAMPLES; i++){
+    uint16_t value = amount[i];
+    int j = i - 1;
+    while((j >= 0) && (amount[j] > value)){
+      amount[j + 1] = amount[j];
+      j--;
+    }
+    amount[j + 1] = value;
+  }
+}
@@ -0,0 +1,211 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* The register access functions of ADXL345_WE are virtual. This sketch shows
+* how to use this for recording and replaying the bus traffic:
+*
+* ADXL345_Recorder prints every read of the data registers, INT_SOURCE,
+* ACT_TAP_STATUS and FIFO_STATUS as initializer line for recording[], with
+* a time stamp (micros):
+*   {micros, register, number of bytes, {byte0, byte1, ...}},
+* A failed read is recorded with 0 bytes. All other lines are printed as
+* comments. Copy the output of the serial monitor into recording[] (or into
+* a header file) to replay it.
+*
+* ADXL345_Replay feeds recorded reads back into the library, without a
+* sensor. It is based on ADXL345_RegisterImage: writes and the reads of
+* registers which are not recorded go to a register image, so that init()
+* and the setters work as usual. Recorded failed reads fail again, records
+* of registers which are not read are skipped. This way, the recorded data
+* run through exactly the same calculations (getGValues(), getAngles(),
+* getOrientation(), ...) at full speed. The sketch replays a small built-in
+* recording and prints the throughput.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<Wire.h>
+#include<ADXL345_WE.h>
+#include<ADXL345_RegisterImage.h>
+#define ADXL345_I2CADDR 0x53 // 0x1D if SDO = HIGH
+#define RECORD 0  // 1 = record from a connected ADXL345, 0 = replay
+#define REPLAY_ROUNDS 1000
+
+struct adxl345_record {
+  unsigned long time;  // micros() at recording
+  uint8_t reg;
+  uint8_t len;         // 0 = failed read
+  uint8_t data[6];
+};
+
+/* The reads which are recorded / replayed */
+bool isRecorded(uint8_t reg, uint8_t count) {
+  return (((reg == ADXL345_DATAX0) && (count == 6)) || (reg == ADXL345_INT_SOURCE)
+    || (reg == ADXL345_ACT_TAP_STATUS) || (reg == ADXL345_FIFO_STATUS)) && (count <= 6);
+}
+
+class ADXL345_Recorder : public ADXL345_WE {
+public:
+  ADXL345_Recorder(int addr) : ADXL345_WE(addr) {}
+
+protected:
+  uint8_t readRegister8(uint8_t reg) {
+    uint8_t val = ADXL345_WE::readRegister8(reg);
+    if(isRecorded(reg, 1)){
+      printRecord(reg, &val, 1);
+    }
+    return val;
+  }
+
+  bool readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count) {
+    bool ok = ADXL345_WE::readMultipleRegisters(reg, buf, count);
+    if(isRecorded(reg, count)){
+      printRecord(reg, buf, ok ? count : 0);  // buf is not valid after a failed read
+    }
+    return ok;
+  }
+
+private:
+  void printRecord(uint8_t reg, uint8_t *buf, uint8_t count) {
+    Serial.print("  {");
+    Serial.print(micros());
+    Serial.print(", ");
+    Serial.print(reg);
+    Serial.print(", ");
+    Serial.print(count);
+    Serial.print(", {");
+    for(int i=0; i<count; i++){
+      if(i > 0){
+        Serial.print(", ");
+      }
+      Serial.print("0x");
+      if(buf[i] < 0x10){
+        Serial.print("0");
+      }
+      Serial.print(buf[i], HEX);
+    }
+    Serial.println("}},");
+  }
+};
+
+class ADXL345_Replay : public ADXL345_RegisterImage {
+public:
+  ADXL345_Replay(const adxl345_record *rec, unsigned int numberOfRecords)
+    : ADXL345_RegisterImage(), records(rec), noOfRecords(numberOfRecords), nextRecord(0) {}
+
+  void rewind() { nextRecord = 0; }
+  bool finished() { return nextRecord >= noOfRecords; }
+
+protected:
+  uint8_t readRegister8(uint8_t reg) {
+    if(!isRecorded(reg, 1)){
+      return ADXL345_RegisterImage::readRegister8(reg);
+    }
+    uint8_t val = 0;
+    if(recordFits(reg)){
+      if(records[nextRecord].len == 1){
+        val = records[nextRecord].data[0];
+      }
+      nextRecord++;
+    }
+    return val;
+  }
+
+  bool readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count) {
+    if(!isRecorded(reg, count)){
+      return ADXL345_RegisterImage::readMultipleRegisters(reg, buf, count);
+    }
+    if(!recordFits(reg)){
+      return false;  // end of the recording
+    }
+    const adxl345_record *rec = &records[nextRecord++];
+    if(rec->len != count){
+      return false;  // recorded failed read
+    }
+    for(int i=0; i<count; i++){
+      buf[i] = rec->data[i];
+    }
+    return true;
+  }
+
+private:
+  const adxl345_record *records;
+  unsigned int noOfRecords;
+  unsigned int nextRecord;
+
+  /* Skips the records of other registers, e.g. the INT_SOURCE read in init() */
+  bool recordFits(uint8_t reg) {
+    while((nextRecord < noOfRecords) && (records[nextRecord].reg != reg)){
+      nextRecord++;
+    }
+    return nextRecord < noOfRecords;
+  }
+};
+
+/* A short recording as printed by ADXL345_Recorder: x,y,z data (DATAX0 = 0x32 = 50),
+   low byte first, and one failed read */
+const adxl345_record recording[] = {
+  {1052310, 50, 6, {0x05, 0x00, 0xFB, 0xFF, 0x02, 0x01}},
+  {1152418, 50, 6, {0x80, 0x00, 0x10, 0x00, 0xC0, 0x00}},
+  {1252526, 50, 6, {0x00, 0x01, 0x00, 0x00, 0x08, 0x00}},
+  {1352634, 50, 0, {}},
+  {1452742, 50, 6, {0xF0, 0xFF, 0x01, 0x01, 0xF8, 0xFF}},
+  {1552850, 50, 6, {0x12, 0x00, 0x05, 0xFF, 0x40, 0x00}},
+  {1652958, 50, 6, {0x00, 0x00, 0x00, 0x00, 0x00, 0x01}},
+};
+const unsigned int numberOfRecords = sizeof(recording) / sizeof(recording[0]);
+
+#if RECORD
+ADXL345_Recorder myAcc = ADXL345_Recorder(ADXL345_I2CADDR);
+#else
+ADXL345_Replay myAcc = ADXL345_Replay(recording, numberOfRecords);
+#endif
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  Serial.println("// ADXL345_Sketch - Record and Replay");  // a comment in recording[]
+  Serial.println();
+  if (!myAcc.init()) {
+    Serial.println("// ADXL345 not connected!");
+  }
+  myAcc.setRange(ADXL345_RANGE_4G);
+
+#if !RECORD
+  unsigned long samples = 0;
+  unsigned long failedReads = 0;
+  float gSum = 0.0;
+  unsigned long start = micros();
+  for(int i=0; i<REPLAY_ROUNDS; i++){
+    myAcc.rewind();
+    while(!myAcc.finished()){
+      xyzFloat g = myAcc.getGValues();
+      if(isnan(g.z)){  // recorded failed read
+        failedReads++;
+        continue;
+      }
+      gSum += g.z;
+      samples++;
+    }
+  }
+  unsigned long duration = micros() - start;
+  Serial.print("Replayed samples: ");
+  Serial.println(samples);
+  Serial.print("Failed reads:     ");
+  Serial.println(failedReads);
+  Serial.print("Mean g-z:         ");
+  Serial.println(gSum / samples);
+  Serial.print("Samples per second: ");
+  Serial.println((samples + failedReads) * 1000000.0 / duration);
+#endif
+}
+
+void loop() {
+#if RECORD
+  myAcc.getGValues();
+  delay(100);
+#endif
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+* Example sketch for the ADXL345_WE library
+*
+* This sketch checks the ADXL345_ShockDetector without a sensor. It feeds
+* synthetic data in FIFO sized blocks into the detector and compares the
+* reported events with the expected ones:
+*
+* 1) A positive and a negative half sine pulse, with the maximum between two
+*    samples: one event each, the interpolated peak must match the amplitude.
+* 2) A sustained change of the orientation (1 g tilt, threshold 0.5 g):
+*    no event, it becomes the new static level after the maximum duration.
+* 3) Three 3 g knocks on the new level: three events with the right peaks.
+*
+* The ADXL345 object is an ADXL345_RegisterImage, which answers from a
+* register image in memory. It is only needed for the conversion to g.
+*
+* Further information can be found on:
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+***************************************************************************/
+
+#include<ADXL345_WE.h>
+#include<ADXL345_RegisterImage.h>
+#include<ADXL345_ShockDetector.h>
+#define BLOCK_SIZE 16
+#define MAX_EVENTS 8
+#define PEAK_TOLERANCE 0.03  // 3 percent
+#define MAX_DURATION 128
+
+ADXL345_RegisterImage myAcc = ADXL345_RegisterImage();
+ADXL345_ShockDetector myDetector = ADXL345_ShockDetector();
+
+xyzFloat rawPerG;
+float level[3] = {0.0, 0.0, 1.0};  // static acceleration in g, z up
+int16_t rawXYZ[3*BLOCK_SIZE];
+uint8_t samplesInBlock = 0;
+adxl345_shockEvent events[MAX_EVENTS];
+uint8_t noOfEvents = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("ADXL345_Sketch - Shock Detector Check");
+  Serial.println();
+  myAcc.init();
+  myAcc.setRange(ADXL345_RANGE_16G);
+  rawPerG = myAcc.getRawPerG();
+  myDetector.setThreshold(&myAcc, 0.5);
+  myDetector.setMaxDuration(MAX_DURATION);
+  myDetector.setShockHandler(onShock);
+  bool passed = true;
+
+  rest(200);
+  noOfEvents = 0;
+  pulse(0, 2.0, 10, 0.3);
+  rest(100);
+  passed &= checkEvents("Pulse x = +2 g", 1);
+  passed &= checkPeak(0, 0, 2.0);
+
+  noOfEvents = 0;
+  pulse(1, -1.5, 12, 0.7);
+  rest(100);
+  passed &= checkEvents("Pulse y = -1.5 g", 1);
+  passed &= checkPeak(0, 1, -1.5);
+
+  noOfEvents = 0;
+  level[0] = 1.0;  // tilt by 90 degrees: x up
+  level[2] = 0.0;
+  rest(400);
+  passed &= checkEvents("Tilt by 1 g", 0);
+  if(myDetector.getLastShock().peak.y > -1.0){   // must still be the y pulse
+    Serial.println("  Tilt overwrote the last shock");
+    passed = false;
+  }
+
+  for(int i=0; i<3; i++){
+    pulse(2, 3.0, 8, 0.5);
+    rest(200);
+  }
+  passed &= checkEvents("3 knocks z = +3 g after tilt", 3);
+  for(int i=0; i<noOfEvents; i++){
+    passed &= checkPeak(i, 2, 3.0);
+  }
+
+  Serial.println(passed ? "PASS" : "FAIL");
+}
+
+void loop() {
+}
+
+void onShock(const adxl345_shockEvent *shock){
+  if(noOfEvents < MAX_EVENTS){
+    events[noOfEvents] = *shock;
+  }
+  noOfEvents++;
+}
+
+/* Adds one sample (static level + deviation in g) and processes full blocks */
+void addSample(const float *deviation){
+  for(int i=0; i<3; i++){
+    float rawPerGAxis = (i == 0) ? rawPerG.x : ((i == 1) ? rawPerG.y : rawPerG.z);
+    rawXYZ[3*samplesInBlock + i] = (int16_t)round((level[i] + deviation[i]) * rawPerGAxis);
+  }
+  samplesInBlock++;
+  if(samplesInBlock == BLOCK_SIZE){
+    myDetector.processBlock(rawXYZ, samplesInBlock);
+    samplesInBlock = 0;
+  }
+}
+
+void rest(int samples){
+  float deviation[3] = {0.0, 0.0, 0.0};
+  for(int i=0; i<samples; i++){
+    addSample(deviation);
+  }
+}
+
+/* Half sine pulse of 'width' samples; phase (0...1) shifts the maximum between two samples */
+void pulse(int axis, float amplitude, int width, float phase){
+  float deviation[3] = {0.0, 0.0, 0.0};
+  for(int i=0; i<=width; i++){
+    deviation[axis] = amplitude * sin(M_PI * (i + phase) / (width + 1));
+    addSample(deviation);
+  }
+}
+
+bool checkEvents(const char *name, uint8_t expected){
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(noOfEvents);
+  Serial.print(" event(s), expected ");
+  Serial.println(expected);
+  return noOfEvents == expected;
+}
+
+bool checkPeak(int event, int axis, float expected){
+  if(event >= noOfEvents){
+    return false;
+  }
+  xyzFloat peak = events[event].peak;
+  float peakAxis = (axis == 0) ? peak.x : ((axis == 1) ? peak.y : peak.z);
+  Serial.print("  Peak: ");
+  Serial.print(peakAxis, 3);
+  Serial.print(" g, expected ");
+  Serial.println(expected, 3);
+  return fabs(peakAxis - expected) <= fabs(expected) * PEAK_TOLERANCE;
+}
@@ -0,0 +1,113 @@
+/********************************************************************
+* This is a library for the ADXL345 accelerometer.
+*
+* Report by exception output stage, see ADXL345_DeadbandFilter.h
+*
+* Written by Wolfgang (Wolle) Ewald
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+*********************************************************************/
+
+#include "ADXL345_DeadbandFilter.h"
+
+ADXL345_DeadbandFilter::ADXL345_DeadbandFilter(){
+    for(uint8_t i=0; i<3; i++){
+        deadband[i] = 0;
+        lastOutput[i] = 0;
+    }
+    heartbeat = 0;
+    reset();
+}
+
+/* Dead bands in g. They are converted with the current range and calibration of acc, so call
+   this function again after changing the range or the correction factors. */
+void ADXL345_DeadbandFilter::setDeadband(ADXL345_WE *acc, float xDeadband, float yDeadband, float zDeadband){
+    xyzFloat rawPerG = acc->getRawPerG();
+    deadband[0] = gToRaw(xDeadband, rawPerG.x);
+    deadband[1] = gToRaw(yDeadband, rawPerG.y);
+    deadband[2] = gToRaw(zDeadband, rawPerG.z);
+}
+
+/* A sample is passed on at least every 'samples' samples; 0 = no heartbeat */
+void ADXL345_DeadbandFilter::setHeartbeat(uint16_t samples){
+    heartbeat = samples;
+}
+
+/* Returns true if the x,y,z triple shall be passed on */
+bool ADXL345_DeadbandFilter::check(const int16_t *rawXYZ){
+    bool output = noOutputYet;
+    inputCount++;
+    samplesSinceOutput++;
+
+    if(heartbeat && (samplesSinceOutput >= heartbeat)){
+        output = true;
+    }
+    for(uint8_t i=0; (i<3) && !output; i++){
+        int32_t diff = (int32_t)rawXYZ[i] - lastOutput[i];
+        if(diff > deadband[i] || diff < -deadband[i]){
+            output = true;
+        }
+    }
+    if(output){
+        lastOutput[0] = rawXYZ[0];
+        lastOutput[1] = rawXYZ[1];
+        lastOutput[2] = rawXYZ[2];
+        noOutputYet = false;
+        samplesSinceOutput = 0;
+        outputCount++;
+    }
+    return output;
+}
+
+/* Removes the samples not to be passed on from a block of x,y,z triples (x0,y0,z0,x1,...).
+   The remaining samples are moved to the beginning. Returns their number. */
+uint8_t ADXL345_DeadbandFilter::filterBlock(int16_t *rawXYZ, uint8_t samples){
+    uint8_t kept = 0;
+    for(uint8_t i=0; i<samples; i++){
+        if(check(&rawXYZ[3*i])){
+            if(kept != i){
+                rawXYZ[3*kept]     = rawXYZ[3*i];
+                rawXYZ[3*kept + 1] = rawXYZ[3*i + 1];
+                rawXYZ[3*kept + 2] = rawXYZ[3*i + 2];
+            }
+            kept++;
+        }
+    }
+    return kept;
+}
+
+uint32_t ADXL345_DeadbandFilter::getNumberOfInputSamples(){
+    return inputCount;
+}
+
+uint32_t ADXL345_DeadbandFilter::getNumberOfOutputSamples(){
+    return outputCount;
+}
+
+/* Input samples per output sample */
+float ADXL345_DeadbandFilter::getCompressionRatio(){
+    if(outputCount == 0){
+        return 0.0;
+    }
+    return (float)inputCount / outputCount;
+}
+
+/* Resets the statistics. The next sample will be passed on in any case. */
+void ADXL345_DeadbandFilter::reset(){
+    noOutputYet = true;
+    samplesSinceOutput = 0;
+    inputCount = 0;
+    outputCount = 0;
+}
+
+int16_t ADXL345_DeadbandFilter::gToRaw(float g, float rawPerG){
+    float raw = round(g * rawPerG);
+    if(raw < 0){
+        raw = 0;
+    }
+    else if(raw > 32767){
+        raw = 32767;
+    }
+    return (int16_t)raw;
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * This is a library for the ADXL345 accelerometer.
+ *
+ * ADXL345_DeadbandFilter is an output stage for FIFO data (report by exception).
+ * A sample is only passed on if it differs from the last passed sample by more
+ * than a dead band on at least one axis, or if the heartbeat interval expired.
+ * The dead band is defined in g and converted into raw values once, so the
+ * comparison itself needs integer arithmetic only.
+ *
+ * Written by Wolfgang (Wolle) Ewald
+ * https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+ * https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+ *
+ *
+ ******************************************************************************/
+
+#ifndef ADXL345_DEADBAND_FILTER_H_
+#define ADXL345_DEADBAND_FILTER_H_
+
+#include "ADXL345_WE.h"
+
+class ADXL345_DeadbandFilter
+{
+public:
+    ADXL345_DeadbandFilter();
+
+    void setDeadband(ADXL345_WE *acc, float xDeadband, float yDeadband, float zDeadband);
+    void setHeartbeat(uint16_t samples);
+    bool check(const int16_t *rawXYZ);
+    uint8_t filterBlock(int16_t *rawXYZ, uint8_t samples);
+    uint32_t getNumberOfInputSamples();
+    uint32_t getNumberOfOutputSamples();
+    float getCompressionRatio();
+    void reset();
+
+private:
+    int16_t deadband[3];
+    int16_t lastOutput[3];
+    bool noOutputYet;
+    uint16_t heartbeat;
+    uint16_t samplesSinceOutput;
+    uint32_t inputCount;
+    uint32_t outputCount;
+    int16_t gToRaw(float g, float rawPerG);
+};
+
+#endif
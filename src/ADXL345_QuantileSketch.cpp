@@ -0,0 +1,140 @@
+/********************************************************************
+* This is a library for the ADXL345 accelerometer.
+*
+* Fixed memory quantile sketch, see ADXL345_QuantileSketch.h
+*
+* Written by Wolfgang (Wolle) Ewald
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+*********************************************************************/
+
+#include "ADXL345_QuantileSketch.h"
+
+ADXL345_QuantileSketch::ADXL345_QuantileSketch(){
+    for(uint8_t i=0; i<3; i++){
+        rawOffset[i] = 0;
+    }
+    reset();
+}
+
+/* Takes the offsets from the current range and calibration of acc (rounded to raw values). Call 
+   this function after setCorrFactors() and setRange() and before adding samples. */
+void ADXL345_QuantileSketch::setOffsets(ADXL345_WE *acc){
+    xyzFloat rawOffsets = acc->getRawOffsets();
+    rawOffset[0] = (int16_t)round(rawOffsets.x);
+    rawOffset[1] = (int16_t)round(rawOffsets.y);
+    rawOffset[2] = (int16_t)round(rawOffsets.z);
+}
+
+void ADXL345_QuantileSketch::addSample(const int16_t *rawXYZ){
+    bucketCount[0][bucketIndex((int32_t)rawXYZ[0] - rawOffset[0])]++;
+    bucketCount[1][bucketIndex((int32_t)rawXYZ[1] - rawOffset[1])]++;
+    bucketCount[2][bucketIndex((int32_t)rawXYZ[2] - rawOffset[2])]++;
+    totalCount++;
+}
+
+/* Adds a block of x,y,z triples (x0,y0,z0,x1,...), e.g. from getFifoRawValues() */
+void ADXL345_QuantileSketch::addBlock(const int16_t *rawXYZ, uint16_t samples){
+    for(uint16_t i=0; i<samples; i++){
+        addSample(&rawXYZ[3*i]);
+    }
+}
+
+void ADXL345_QuantileSketch::merge(const ADXL345_QuantileSketch *other){
+    for(uint8_t axis=0; axis<3; axis++){
+        for(uint16_t i=0; i<ADXL345_QUANTILE_BUCKETS; i++){
+            bucketCount[axis][i] += other->bucketCount[axis][i];
+        }
+    }
+    totalCount += other->totalCount;
+}
+
+/* q = 0.0 ... 1.0, e.g. 0.99 for p99. Returns the quantiles of |x|, |y|, |z| as raw values. */
+xyzFloat ADXL345_QuantileSketch::getRawQuantile(float q){
+    xyzFloat quantile = {0.0, 0.0, 0.0};
+    if(totalCount == 0){
+        return quantile;
+    }
+    if(q < 0.0){
+        q = 0.0;
+    }
+    else if(q > 1.0){
+        q = 1.0;
+    }
+    uint32_t rank = (uint32_t)ceil(q * totalCount);
+    if(rank < 1){
+        rank = 1;
+    }
+    quantile.x = rawQuantile(0, rank);
+    quantile.y = rawQuantile(1, rank);
+    quantile.z = rawQuantile(2, rank);
+    return quantile;
+}
+
+/* As getRawQuantile(), but in g, converted with the current range and calibration of acc */
+xyzFloat ADXL345_QuantileSketch::getQuantile(ADXL345_WE *acc, float q){
+    xyzFloat quantile = getRawQuantile(q);
+    xyzFloat rawPerG = acc->getRawPerG();
+    quantile.x /= rawPerG.x;
+    quantile.y /= rawPerG.y;
+    quantile.z /= rawPerG.z;
+    return quantile;
+}
+
+uint32_t ADXL345_QuantileSketch::getCount(){
+    return totalCount;
+}
+
+void ADXL345_QuantileSketch::reset(){
+    for(uint8_t axis=0; axis<3; axis++){
+        for(uint16_t i=0; i<ADXL345_QUANTILE_BUCKETS; i++){
+            bucketCount[axis][i] = 0;
+        }
+    }
+    totalCount = 0;
+}
+
+/************************************************
+    private functions
+*************************************************/
+
+uint16_t ADXL345_QuantileSketch::bucketIndex(int32_t raw){
+    uint32_t amount = (raw < 0) ? -raw : raw;
+    if(amount < ADXL345_QUANTILE_LINEAR){
+        return amount;
+    }
+    if(amount >= (1UL << (ADXL345_QUANTILE_MAX_BIT + 1))){
+        return ADXL345_QUANTILE_BUCKETS - 1;
+    }
+    uint8_t highestBit = ADXL345_QUANTILE_SUB_BITS + 1;
+    while(amount >> (highestBit + 1)){
+        highestBit++;
+    }
+    uint16_t subBucket = (amount >> (highestBit - ADXL345_QUANTILE_SUB_BITS)) & ((1 << ADXL345_QUANTILE_SUB_BITS) - 1);
+    return ADXL345_QUANTILE_LINEAR + (highestBit - ADXL345_QUANTILE_SUB_BITS - 1) * (1 << ADXL345_QUANTILE_SUB_BITS) + subBucket;
+}
+
+/* Middle of the bucket */
+float ADXL345_QuantileSketch::bucketValue(uint16_t index){
+    if(index < ADXL345_QUANTILE_LINEAR){
+        return index;
+    }
+    index -= ADXL345_QUANTILE_LINEAR;
+    uint8_t highestBit = ADXL345_QUANTILE_SUB_BITS + 1 + (index >> ADXL345_QUANTILE_SUB_BITS);
+    uint16_t subBucket = index & ((1 << ADXL345_QUANTILE_SUB_BITS) - 1);
+    uint16_t width = 1 << (highestBit - ADXL345_QUANTILE_SUB_BITS);
+    uint16_t lower = (1 << highestBit) + subBucket * width;
+    return lower + (width - 1) * 0.5;
+}
+
+float ADXL345_QuantileSketch::rawQuantile(uint8_t axis, uint32_t rank){
+    uint32_t cumulated = 0;
+    for(uint16_t i=0; i<ADXL345_QUANTILE_BUCKETS; i++){
+        cumulated += bucketCount[axis][i];
+        if(cumulated >= rank){
+            return bucketValue(i);
+        }
+    }
+    return bucketValue(ADXL345_QUANTILE_BUCKETS - 1);
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ * This is a library for the ADXL345 accelerometer.
+ *
+ * ADXL345_QuantileSketch collects the distribution of the acceleration amounts
+ * |x|, |y|, |z| of any number of raw samples in a fixed amount of memory and
+ * delivers quantiles like p50, p95, p99 or p99.9.
+ *
+ * The offsets from setCorrFactors() are subtracted before the amounts are taken
+ * (see setOffsets()), so the quantiles refer to the corrected values as
+ * delivered by getCorrectedRawValues() and getGValues().
+ *
+ * The raw amounts are counted in log-linear buckets: amounts below
+ * 2^(SUB_BITS+1) have their own bucket, above that every power of two range is
+ * split into 2^SUB_BITS buckets. The result is the middle of the bucket which
+ * contains the requested rank. Error bound: the returned quantile differs from
+ * the exact quantile of the collected samples by at most 2^-(SUB_BITS+1) of its
+ * value (3.1% for the default SUB_BITS = 4), amounts below 2^(SUB_BITS+1) are
+ * exact. Amounts above 8191 (beyond the 13 bit full resolution) are counted
+ * in the top bucket.
+ *
+ * Sketches can be merged (e.g. several sensors or time windows), provided they
+ * were filled with the same range settings (the offsets may differ). Memory: 3 x ADXL345_QUANTILE_BUCKETS
+ * x 4 bytes, which is 1920 bytes for SUB_BITS = 4 and 1056 bytes for SUB_BITS = 3.
+ * To change SUB_BITS, edit the define below or set it as build flag.
+ *
+ * Written by Wolfgang (Wolle) Ewald
+ * https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+ * https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+ *
+ *
+ ******************************************************************************/
+
+#ifndef ADXL345_QUANTILE_SKETCH_H_
+#define ADXL345_QUANTILE_SKETCH_H_
+
+#include "ADXL345_WE.h"
+
+#ifndef ADXL345_QUANTILE_SUB_BITS
+#define ADXL345_QUANTILE_SUB_BITS   4
+#endif
+#define ADXL345_QUANTILE_MAX_BIT    12  // highest bit of a 13 bit amount
+#define ADXL345_QUANTILE_LINEAR     (1 << (ADXL345_QUANTILE_SUB_BITS + 1))
+#define ADXL345_QUANTILE_BUCKETS    (ADXL345_QUANTILE_LINEAR + \
+    (ADXL345_QUANTILE_MAX_BIT - ADXL345_QUANTILE_SUB_BITS) * (1 << ADXL345_QUANTILE_SUB_BITS))
+
+class ADXL345_QuantileSketch
+{
+public:
+    ADXL345_QuantileSketch();
+
+    void setOffsets(ADXL345_WE *acc);
+    void addSample(const int16_t *rawXYZ);
+    void addBlock(const int16_t *rawXYZ, uint16_t samples);
+    void merge(const ADXL345_QuantileSketch *other);
+    xyzFloat getRawQuantile(float q);
+    xyzFloat getQuantile(ADXL345_WE *acc, float q);
+    uint32_t getCount();
+    void reset();
+
+private:
+    uint32_t bucketCount[3][ADXL345_QUANTILE_BUCKETS];
+    uint32_t totalCount;
+    int16_t rawOffset[3];
+    uint16_t bucketIndex(int32_t raw);
+    float bucketValue(uint16_t index);
+    float rawQuantile(uint8_t axis, uint32_t rank);
+};
+
+#endif
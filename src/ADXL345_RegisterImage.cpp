@@ -0,0 +1,62 @@
+/********************************************************************
+* This is a library for the ADXL345 accelerometer.
+*
+* ADXL345_WE without a sensor, see ADXL345_RegisterImage.h
+*
+* Written by Wolfgang (Wolle) Ewald
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+*********************************************************************/
+
+#include "ADXL345_RegisterImage.h"
+
+ADXL345_RegisterImage::ADXL345_RegisterImage() : ADXL345_WE(){
+    for(uint8_t i=0; i<64; i++){
+        regImage[i] = 0;
+    }
+}
+
+/* Sets the data registers (DATAX0 to DATAZ1), as read by getRawValues(), getGValues(), etc. */
+void ADXL345_RegisterImage::setRawValues(int16_t x, int16_t y, int16_t z){
+    int16_t xyz[3] = {x, y, z};
+    for(uint8_t i=0; i<3; i++){
+        regImage[ADXL345_DATAX0 + 2*i] = (uint8_t)(xyz[i] & 0xFF);
+        regImage[ADXL345_DATAX0 + 2*i + 1] = (uint8_t)((uint16_t)xyz[i] >> 8);
+    }
+}
+
+void ADXL345_RegisterImage::setRegister(uint8_t reg, uint8_t val){
+    regImage[reg & 0x3F] = val;
+}
+
+uint8_t ADXL345_RegisterImage::getRegister(uint8_t reg){
+    return regImage[reg & 0x3F];
+}
+
+/************************************************
+    protected functions
+*************************************************/
+
+uint8_t ADXL345_RegisterImage::writeRegister(uint8_t reg, uint8_t val){
+    regImage[reg & 0x3F] = val;
+    return 0;
+}
+
+uint8_t ADXL345_RegisterImage::readRegister8(uint8_t reg){
+    return regImage[reg & 0x3F];
+}
+
+bool ADXL345_RegisterImage::readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count){
+    for(uint8_t i=0; i<count; i++){
+        buf[i] = regImage[(reg + i) & 0x3F];
+    }
+    return true;
+}
+
+uint8_t ADXL345_RegisterImage::writeMultipleRegisters(uint8_t reg, const uint8_t *buf, uint8_t count){
+    for(uint8_t i=0; i<count; i++){
+        regImage[(reg + i) & 0x3F] = buf[i];
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ *
+ * This is a library for the ADXL345 accelerometer.
+ *
+ * ADXL345_RegisterImage is an ADXL345_WE without a sensor. All register
+ * accesses go to an image of the 64 registers in memory: writes are stored,
+ * reads return the stored values. Use it to run the calculations of the
+ * library on given data (setRawValues()), for benchmarks and for checks
+ * without hardware, or as base class for replaying recorded data.
+ *
+ * Written by Wolfgang (Wolle) Ewald
+ * https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+ * https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+ *
+ *
+ ******************************************************************************/
+
+#ifndef ADXL345_REGISTER_IMAGE_H_
+#define ADXL345_REGISTER_IMAGE_H_
+
+#include "ADXL345_WE.h"
+
+class ADXL345_RegisterImage : public ADXL345_WE
+{
+public:
+    ADXL345_RegisterImage();
+
+    void setRawValues(int16_t x, int16_t y, int16_t z);
+    void setRegister(uint8_t reg, uint8_t val);
+    uint8_t getRegister(uint8_t reg);
+
+protected:
+    uint8_t writeRegister(uint8_t reg, uint8_t val);
+    uint8_t readRegister8(uint8_t reg);
+    bool readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count);
+    uint8_t writeMultipleRegisters(uint8_t reg, const uint8_t *buf, uint8_t count);
+
+private:
+    uint8_t regImage[64];
+};
+
+#endif
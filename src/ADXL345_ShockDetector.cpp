@@ -0,0 +1,203 @@
+/********************************************************************
+* This is a library for the ADXL345 accelerometer.
+*
+* Block based shock detector, see ADXL345_ShockDetector.h
+*
+* Written by Wolfgang (Wolle) Ewald
+* https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+* https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+*
+*********************************************************************/
+
+#include "ADXL345_ShockDetector.h"
+
+ADXL345_ShockDetector::ADXL345_ShockDetector(){
+    shockHandler = NULL;
+    rawPerG.x = 1.0;
+    rawPerG.y = 1.0;
+    rawPerG.z = 1.0;
+    for(uint8_t i=0; i<3; i++){
+        startThreshold[i] = 32767;
+        endThreshold[i] = 32767;
+    }
+    maxDuration = ADXL345_MAX_SHOCK_DURATION;
+    reset();
+}
+
+/* Threshold in g. It is converted with the current range and calibration of acc, so call this
+   function again after changing the range or the correction factors. */
+void ADXL345_ShockDetector::setThreshold(ADXL345_WE *acc, float threshold){
+    rawPerG = acc->getRawPerG();
+    float rawThreshold[3] = {threshold * rawPerG.x, threshold * rawPerG.y, threshold * rawPerG.z};
+    for(uint8_t i=0; i<3; i++){
+        if(rawThreshold[i] < 2){
+            rawThreshold[i] = 2;
+        }
+        else if(rawThreshold[i] > 32767){
+            rawThreshold[i] = 32767;
+        }
+        startThreshold[i] = (int16_t)round(rawThreshold[i]);
+        endThreshold[i] = startThreshold[i] / 2;
+    }
+}
+
+/* Maximum duration of a shock in samples. A deviation lasting longer is a new static level and not
+   reported (no handler call, getLastShock() and the return value of processBlock() unchanged).
+   The current level becomes the new baseline. */
+void ADXL345_ShockDetector::setMaxDuration(uint16_t samples){
+    if(samples < 1){
+        samples = 1;
+    }
+    maxDuration = samples;
+}
+
+/* The handler is called at the end of every shock. Pass NULL to remove it. */
+void ADXL345_ShockDetector::setShockHandler(adxl345_shockHandler handler){
+    shockHandler = handler;
+}
+
+/* Processes a block of x,y,z triples (x0,y0,z0,x1,...), e.g. from getFifoRawValues().
+   Shocks may extend over several blocks. Returns the number of shocks finished in this block. */
+uint8_t ADXL345_ShockDetector::processBlock(const int16_t *rawXYZ, uint8_t samples){
+    uint8_t shocks = 0;
+    for(uint8_t i=0; i<samples; i++){
+        if(processSample(&rawXYZ[3*i])){
+            shocks++;
+        }
+    }
+    return shocks;
+}
+
+adxl345_shockEvent ADXL345_ShockDetector::getLastShock(){
+    return lastShock;
+}
+
+/* Restarts the sample counter and the baseline, which is taken from the next sample */
+void ADXL345_ShockDetector::reset(){
+    for(uint8_t i=0; i<3; i++){
+        baselineSum[i] = 0;
+        prevDev[i] = 0;
+    }
+    baselineValid = false;
+    sampleNo = 0;
+    inShock = false;
+    lastShock.start = 0;
+    lastShock.duration = 0;
+    lastShock.peak.x = lastShock.peak.y = lastShock.peak.z = 0.0;
+    lastShock.energy.x = lastShock.energy.y = lastShock.energy.z = 0.0;
+}
+
+/************************************************
+    private functions
+*************************************************/
+
+/* Returns true if a shock ended with this sample */
+bool ADXL345_ShockDetector::processSample(const int16_t *rawXYZ){
+    int16_t dev[3];
+    bool aboveStart = false;
+    bool aboveEnd = false;
+
+    if(!baselineValid){
+        restartBaseline(rawXYZ);
+    }
+    for(uint8_t i=0; i<3; i++){
+        dev[i] = rawXYZ[i] - (int16_t)(baselineSum[i] >> ADXL345_BASELINE_SHIFT);
+        int16_t absDev = (dev[i] < 0) ? -dev[i] : dev[i];
+        if(absDev > startThreshold[i]){
+            aboveStart = true;
+        }
+        if(absDev > endThreshold[i]){
+            aboveEnd = true;
+        }
+    }
+
+    bool shockFinished = false;
+    if(!inShock && aboveStart){
+        inShock = true;
+        shockStart = sampleNo;
+        shockDuration = 0;
+        for(uint8_t i=0; i<3; i++){
+            peakPrev[i] = prevDev[i];
+            peakDev[i] = 0;
+            peakNext[i] = 0;
+            peakNextPending[i] = false;
+            energySum[i] = 0;
+        }
+    }
+    if(inShock){
+        for(uint8_t i=0; i<3; i++){
+            if(peakNextPending[i]){
+                peakNext[i] = dev[i];
+                peakNextPending[i] = false;
+            }
+            int16_t absDev = (dev[i] < 0) ? -dev[i] : dev[i];
+            int16_t absPeak = (peakDev[i] < 0) ? -peakDev[i] : peakDev[i];
+            if(absDev > absPeak){
+                peakPrev[i] = prevDev[i];
+                peakDev[i] = dev[i];
+                peakNextPending[i] = true;
+            }
+            energySum[i] += (uint32_t)((int32_t)dev[i] * dev[i]);
+        }
+        if(shockDuration < 0xFFFF){
+            shockDuration++;
+        }
+        if(!aboveEnd){
+            finishShock();
+            shockFinished = true;
+        }
+        else if(shockDuration >= maxDuration){   // new static level, not a shock
+            inShock = false;
+            restartBaseline(rawXYZ);
+            for(uint8_t i=0; i<3; i++){
+                dev[i] = 0;
+            }
+        }
+    }
+    else{   // the baseline is only tracked outside of shocks
+        for(uint8_t i=0; i<3; i++){
+            baselineSum[i] += rawXYZ[i] - (baselineSum[i] >> ADXL345_BASELINE_SHIFT);
+        }
+    }
+
+    for(uint8_t i=0; i<3; i++){
+        prevDev[i] = dev[i];
+    }
+    sampleNo++;
+    return shockFinished;
+}
+
+void ADXL345_ShockDetector::restartBaseline(const int16_t *rawXYZ){
+    for(uint8_t i=0; i<3; i++){
+        baselineSum[i] = (int32_t)rawXYZ[i] << ADXL345_BASELINE_SHIFT;
+    }
+    baselineValid = true;
+}
+
+void ADXL345_ShockDetector::finishShock(){
+    inShock = false;
+    lastShock.start = shockStart;
+    lastShock.duration = shockDuration;
+    lastShock.peak.x = interpolatePeak(0) / rawPerG.x;
+    lastShock.peak.y = interpolatePeak(1) / rawPerG.y;
+    lastShock.peak.z = interpolatePeak(2) / rawPerG.z;
+    lastShock.energy.x = energySum[0] / (rawPerG.x * rawPerG.x);
+    lastShock.energy.y = energySum[1] / (rawPerG.y * rawPerG.y);
+    lastShock.energy.z = energySum[2] / (rawPerG.z * rawPerG.z);
+    if(shockHandler){
+        shockHandler(&lastShock);
+    }
+}
+
+/* Vertex of the parabola through the peak sample and its neighbours (signed raw value) */
+float ADXL345_ShockDetector::interpolatePeak(uint8_t axis){
+    float sign = (peakDev[axis] < 0) ? -1.0 : 1.0;
+    float y0 = sign * peakPrev[axis];
+    float y1 = sign * peakDev[axis];
+    float y2 = sign * peakNext[axis];
+    float denominator = y0 - 2.0 * y1 + y2;
+    if(peakNextPending[axis] || denominator >= 0.0){
+        return peakDev[axis];
+    }
+    return sign * (y1 - (y0 - y2) * (y0 - y2) / (8.0 * denominator));
+}
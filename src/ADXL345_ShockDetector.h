@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * This is a library for the ADXL345 accelerometer.
+ *
+ * ADXL345_ShockDetector scans blocks of raw FIFO data for shocks. A shock starts
+ * when the deviation from the baseline (slowly tracked static acceleration incl.
+ * gravity) exceeds the threshold on at least one axis. It ends when the
+ * deviation on all axes has dropped below half the threshold, or when it has
+ * lasted the maximum duration. In the latter case the deviation is not a shock
+ * but a new static level (e.g. a change of the orientation): it is not
+ * reported and the baseline is restarted from the current sample. For each shock,
+ * the start (sample number), the duration (samples), the peak deviation per axis
+ * in g (parabolic interpolation between the samples around the maximum) and the
+ * energy per axis (sum of the squared deviations in g^2 x samples; divide by the
+ * data rate to get g^2 x s) are reported.
+ *
+ * The per sample processing uses integer arithmetic only.
+ *
+ * Written by Wolfgang (Wolle) Ewald
+ * https://wolles-elektronikkiste.de/adxl345-teil-1 (German)
+ * https://wolles-elektronikkiste.de/en/adxl345-the-universal-accelerometer-part-1 (English)
+ *
+ *
+ ******************************************************************************/
+
+#ifndef ADXL345_SHOCK_DETECTOR_H_
+#define ADXL345_SHOCK_DETECTOR_H_
+
+#include "ADXL345_WE.h"
+
+#define ADXL345_BASELINE_SHIFT  6   // baseline time constant: 2^6 = 64 samples
+#define ADXL345_MAX_SHOCK_DURATION  128 // default, change with setMaxDuration()
+
+struct adxl345_shockEvent {
+    uint32_t start;
+    uint16_t duration;
+    xyzFloat peak;
+    xyzFloat energy;
+};
+
+typedef void (*adxl345_shockHandler)(const adxl345_shockEvent *shock);
+
+class ADXL345_ShockDetector
+{
+public:
+    ADXL345_ShockDetector();
+
+    void setThreshold(ADXL345_WE *acc, float threshold);
+    void setMaxDuration(uint16_t samples);
+    void setShockHandler(adxl345_shockHandler handler);
+    uint8_t processBlock(const int16_t *rawXYZ, uint8_t samples);
+    adxl345_shockEvent getLastShock();
+    void reset();
+
+private:
+    adxl345_shockHandler shockHandler;
+    adxl345_shockEvent lastShock;
+    xyzFloat rawPerG;
+    int16_t startThreshold[3];
+    int16_t endThreshold[3];
+    uint16_t maxDuration;
+    bool baselineValid;
+    int32_t baselineSum[3];        // baseline x 2^ADXL345_BASELINE_SHIFT
+    int16_t prevDev[3];
+    int16_t peakPrev[3];
+    int16_t peakDev[3];
+    int16_t peakNext[3];
+    bool peakNextPending[3];
+    uint64_t energySum[3];
+    uint32_t sampleNo;
+    uint32_t shockStart;
+    uint16_t shockDuration;
+    bool inShock;
+    bool processSample(const int16_t *rawXYZ);
+    void restartBaseline(const int16_t *rawXYZ);
+    void finishShock();
+    float interpolatePeak(uint8_t axis);
+};
+
+#endif
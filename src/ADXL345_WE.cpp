@@ -16,6 +16,16 @@
 
 #include "ADXL345_WE.h"
 
+#ifdef ADXL345_USE_LATEST_SAMPLE
+static inline void adxl345_memoryBarrier(){
+#if defined(__AVR__)
+    __asm__ __volatile__("" ::: "memory");  // single core: keep the compiler from reordering
+#else
+    __sync_synchronize();
+#endif
+}
+#endif
+
 /************  Constructors ************/
 
 ADXL345_WE::ADXL345_WE(int addr){
@@ -46,23 +56,20 @@ ADXL345_WE::ADXL345_WE(SPIClass *s, int cs, bool spi){
     useSPI = spi;
     _spi = s;
     csPin = cs;  
+    mySPISettings = SPISettings(ADXL345_MAX_SPI_CLOCK, MSBFIRST, SPI_MODE3);
 }
 
 ADXL345_WE::ADXL345_WE(int cs, bool spi){
     useSPI = spi;
     _spi = &SPI;
     csPin = cs;
+    mySPISettings = SPISettings(ADXL345_MAX_SPI_CLOCK, MSBFIRST, SPI_MODE3);
 }
 
 /************ Basic settings ************/
     
 bool ADXL345_WE::init(){    
-    if(useSPI){
-        _spi->begin();
-        _spi->setDataMode(SPI_MODE3);
-        pinMode(csPin, OUTPUT);
-        digitalWrite(csPin, HIGH);
-    }
+    beginSPI();
     writeRegister(ADXL345_POWER_CTL,0);
     writeRegister(ADXL345_POWER_CTL, 16);   
     setMeasureMode(true);
@@ -94,6 +101,19 @@ bool ADXL345_WE::init(){
     return true;
 }
 
+void ADXL345_WE::setSPIClockSpeed(unsigned long clock){
+    if(clock > ADXL345_MAX_SPI_CLOCK){
+        clock = ADXL345_MAX_SPI_CLOCK;
+    }
+    mySPISettings = SPISettings(clock, MSBFIRST, SPI_MODE3);
+}
+
+/* The ADXL345 supports I2C clock rates up to 400 kHz (fast mode). Higher rates may work, but are
+   outside the data sheet specification. Please note that the clock applies to all devices on the bus. */
+void ADXL345_WE::setI2CClockSpeed(unsigned long clock){
+    _wire->setClock(clock);
+}
+
 void ADXL345_WE::setCorrFactors(float xMin, float xMax, float yMin, float yMax, float zMin, float zMax){
     corrFact.x = UNITS_PER_G / (0.5 * (xMax - xMin));
     corrFact.y = UNITS_PER_G / (0.5 * (yMax - yMin));
@@ -104,7 +124,7 @@ void ADXL345_WE::setCorrFactors(float xMin, float xMax, float yMin, float yMax,
 }
 
 void ADXL345_WE::setDataRate(adxl345_dataRate rate){
-    regVal |= readRegister8(ADXL345_BW_RATE);
+    uint8_t regVal = readRegister8(ADXL345_BW_RATE);
     regVal &= 0xF0;
     regVal |= rate;
     writeRegister(ADXL345_BW_RATE, regVal);
@@ -114,6 +134,7 @@ adxl345_dataRate ADXL345_WE::getDataRate(){
     return (adxl345_dataRate)(readRegister8(ADXL345_BW_RATE) & 0x0F);
 }
 
+#ifndef ADXL345_NO_STRINGS
 String ADXL345_WE::getDataRateAsString(){
     adxl345_dataRate dataRate = (adxl345_dataRate)(readRegister8(ADXL345_BW_RATE) & 0x0F);
     String returnString = "";
@@ -139,6 +160,7 @@ String ADXL345_WE::getDataRateAsString(){
     
     return returnString;
 }
+#endif
 
 uint8_t ADXL345_WE::getPowerCtlReg(){
     return readRegister8(ADXL345_POWER_CTL);
@@ -163,13 +185,13 @@ void ADXL345_WE::setRange(adxl345_range range){
 }
 
 adxl345_range ADXL345_WE::getRange(){
-    regVal = readRegister8(ADXL345_DATA_FORMAT);
+    uint8_t regVal = readRegister8(ADXL345_DATA_FORMAT);
     regVal &= 0x03; 
     return adxl345_range(regVal);
 }
 
 void ADXL345_WE::setFullRes(boolean full){
-    regVal = readRegister8(ADXL345_DATA_FORMAT);
+    uint8_t regVal = readRegister8(ADXL345_DATA_FORMAT);
     if(full){
         adxl345_lowRes = false;
         rangeFactor = 1.0;
@@ -183,6 +205,7 @@ void ADXL345_WE::setFullRes(boolean full){
     writeRegister(ADXL345_DATA_FORMAT, regVal);
 }
 
+#ifndef ADXL345_NO_STRINGS
 String ADXL345_WE::getRangeAsString(){
     String rangeAsString = "";
     adxl345_range range = getRange();
@@ -195,39 +218,47 @@ String ADXL345_WE::getRangeAsString(){
     }
     return rangeAsString;
 }
+#endif
 
 /************ x,y,z results ************/
 
+/* If the data registers can't be read, the results are NAN (and so are the results of all
+   functions based on them), not zero. */
 xyzFloat ADXL345_WE::getRawValues(){
-    rawVal.x = readRegister16(ADXL345_DATAX0);
-    rawVal.y = readRegister16(ADXL345_DATAY0);
-    rawVal.z = readRegister16(ADXL345_DATAZ0);
+    xyzFloat rawVal;
+    int16_t rawXYZ[3];
+    if(!readRegister3x16(ADXL345_DATAX0, rawXYZ)){
+        rawVal.x = rawVal.y = rawVal.z = NAN;
+        return rawVal;
+    }
+    rawVal.x = rawXYZ[0];
+    rawVal.y = rawXYZ[1];
+    rawVal.z = rawXYZ[2];
     return rawVal;
 }
 
 xyzFloat ADXL345_WE::getCorrectedRawValues(){
-    uint64_t xyzDataReg = readRegister3x16(ADXL345_DATAX0);
-    int16_t xRaw = (int16_t)((xyzDataReg >> 32) & 0xFFFF);
-    int16_t yRaw = (int16_t)((xyzDataReg >> 16) & 0xFFFF);
-    int16_t zRaw = (int16_t)(xyzDataReg & 0xFFFF);
-    
-    rawVal.x = xRaw - (offsetVal.x / rangeFactor);
-    rawVal.y = yRaw - (offsetVal.y / rangeFactor);
-    rawVal.z = zRaw - (offsetVal.z / rangeFactor);
+    xyzFloat rawVal = getRawValues();
+    rawVal.x -= (offsetVal.x / rangeFactor);
+    rawVal.y -= (offsetVal.y / rangeFactor);
+    rawVal.z -= (offsetVal.z / rangeFactor);
     
     return rawVal;
 }
 
 xyzFloat ADXL345_WE::getGValues(){
-    getCorrectedRawValues();
+    xyzFloat rawVal = getCorrectedRawValues();
+    xyzFloat gVal;
     gVal.x = rawVal.x * MILLI_G_PER_LSB * rangeFactor * corrFact.x / 1000.0;
     gVal.y = rawVal.y * MILLI_G_PER_LSB * rangeFactor * corrFact.y / 1000.0;
     gVal.z = rawVal.z * MILLI_G_PER_LSB * rangeFactor * corrFact.z / 1000.0;
     return gVal;
 }
 
+#ifndef ADXL345_NO_ANGLES
 xyzFloat ADXL345_WE::getAngles(){
-    getGValues();
+    xyzFloat gVal = getGValues();
+    xyzFloat angleVal;
     if(gVal.x > 1){
         gVal.x = 1;
     }
@@ -256,27 +287,136 @@ xyzFloat ADXL345_WE::getAngles(){
 }
 
 xyzFloat ADXL345_WE::getCorrAngles(){
-    getAngles();
-    xyzFloat corrAnglesVal;
-    corrAnglesVal.x = angleVal.x - angleOffsetVal.x;
-    corrAnglesVal.y = angleVal.y - angleOffsetVal.y;
-    corrAnglesVal.z = angleVal.z - angleOffsetVal.z;
+    xyzFloat corrAnglesVal = getAngles();
+    corrAnglesVal.x -= angleOffsetVal.x;
+    corrAnglesVal.y -= angleOffsetVal.y;
+    corrAnglesVal.z -= angleOffsetVal.z;
         
     return corrAnglesVal;
 }
+#endif // ADXL345_NO_ANGLES
+
+/* Reads up to 'samples' x,y,z triples from the FIFO into rawXYZ (x0,y0,z0,x1,...). 
+   Each multi-byte read of DATAX0 to DATAZ1 pops one entry. Returns the number of triples read, 
+   which is less than 'samples' if a read fails. */
+uint8_t ADXL345_WE::getFifoRawValues(int16_t *rawXYZ, uint8_t samples){
+    for(uint8_t i=0; i<samples; i++){
+        if(!readRegister3x16(ADXL345_DATAX0, &rawXYZ[3*i])){
+            return i;
+        }
+        if(useSPI){
+            delayMicroseconds(5); // min. time between two FIFO reads at SPI clock > 1.6 MHz
+        }
+    }
+    return samples;
+}
+
+/* Converts interleaved raw triples into separate x, y, z arrays of g values. Offset, range
+   and correction factors are folded into one factor and one summand per axis beforehand, so 
+   the loops contain nothing but a multiply-add and can be vectorized by the compiler where
+   the target supports it. */
+void ADXL345_WE::convertRawToGValues(const int16_t *rawXYZ, float *gx, float *gy, float *gz, uint16_t samples){
+    float factorX = MILLI_G_PER_LSB * rangeFactor * corrFact.x / 1000.0;
+    float factorY = MILLI_G_PER_LSB * rangeFactor * corrFact.y / 1000.0;
+    float factorZ = MILLI_G_PER_LSB * rangeFactor * corrFact.z / 1000.0;
+    float summandX = -(offsetVal.x / rangeFactor) * factorX;
+    float summandY = -(offsetVal.y / rangeFactor) * factorY;
+    float summandZ = -(offsetVal.z / rangeFactor) * factorZ;
+    
+    for(uint16_t i=0; i<samples; i++){
+        gx[i] = rawXYZ[3*i] * factorX + summandX;
+    }
+    for(uint16_t i=0; i<samples; i++){
+        gy[i] = rawXYZ[3*i + 1] * factorY + summandY;
+    }
+    for(uint16_t i=0; i<samples; i++){
+        gz[i] = rawXYZ[3*i + 2] * factorZ + summandZ;
+    }
+}
+
+/* Raw value units per g for each axis at the current range and calibration. Useful to convert
+   g thresholds into raw values once, so that data can be compared with integer arithmetic. */
+xyzFloat ADXL345_WE::getRawPerG(){
+    xyzFloat rawPerG;
+    rawPerG.x = 1000.0 / (MILLI_G_PER_LSB * rangeFactor * corrFact.x);
+    rawPerG.y = 1000.0 / (MILLI_G_PER_LSB * rangeFactor * corrFact.y);
+    rawPerG.z = 1000.0 / (MILLI_G_PER_LSB * rangeFactor * corrFact.z);
+    return rawPerG;
+}
+
+/* Offsets (from setCorrFactors()) in raw values at the current range. Raw value minus offset is 
+   the corrected raw value, as delivered by getCorrectedRawValues(). */
+xyzFloat ADXL345_WE::getRawOffsets(){
+    xyzFloat rawOffsets;
+    rawOffsets.x = offsetVal.x / rangeFactor;
+    rawOffsets.y = offsetVal.y / rangeFactor;
+    rawOffsets.z = offsetVal.z / rangeFactor;
+    return rawOffsets;
+}
+
+#ifdef ADXL345_USE_LATEST_SAMPLE
+/* Latest sample slot, protected by a sequence lock: only one task / the main loop (the owner) 
+   may call updateLatestSample() and the configuration functions. Other tasks can call 
+   getLatestRawValues() and getLatestGValues() at any time without bus access and without ever 
+   blocking the owner. They retry only if they catch an update in progress. Don't call them from 
+   an ISR that can interrupt the owner on the same core. */
+bool ADXL345_WE::updateLatestSample(){
+    int16_t rawXYZ[3];
+    if(getFifoRawValues(rawXYZ, 1) != 1){
+        return false;  // keep the previous sample
+    }
+    updateLatestSample(rawXYZ);
+    return true;
+}
+
+/* The g values are calculated by the owner and published together with the raw values, so 
+   the readers never use range, offsets and correction factors while the owner changes them. */
+void ADXL345_WE::updateLatestSample(const int16_t *rawXYZ){
+    float gXYZ[3];
+    convertRawToGValues(rawXYZ, &gXYZ[0], &gXYZ[1], &gXYZ[2], 1);
+    latestSeq = latestSeq + 1;
+    adxl345_memoryBarrier();
+    for(uint8_t i=0; i<3; i++){
+        latestRaw[i] = rawXYZ[i];
+        latestG[i] = gXYZ[i];
+    }
+    adxl345_memoryBarrier();
+    latestSeq = latestSeq + 1;
+}
+
+xyzFloat ADXL345_WE::getLatestRawValues(){
+    int16_t rawXYZ[3];
+    float gXYZ[3];
+    xyzFloat rawVal;
+    readLatestSample(rawXYZ, gXYZ);
+    rawVal.x = rawXYZ[0];
+    rawVal.y = rawXYZ[1];
+    rawVal.z = rawXYZ[2];
+    return rawVal;
+}
+
+xyzFloat ADXL345_WE::getLatestGValues(){
+    int16_t rawXYZ[3];
+    float gXYZ[3];
+    xyzFloat gVal;
+    readLatestSample(rawXYZ, gXYZ);
+    gVal.x = gXYZ[0];
+    gVal.y = gXYZ[1];
+    gVal.z = gXYZ[2];
+    return gVal;
+}
+#endif
 
 /************ Angles and Orientation ************/ 
 
+#ifndef ADXL345_NO_ANGLES
 void ADXL345_WE::measureAngleOffsets(){
-    getAngles();
-    angleOffsetVal.x = angleVal.x; 
-    angleOffsetVal.y = angleVal.y;
-    angleOffsetVal.z = angleVal.z;
+    angleOffsetVal = getAngles();
 }
 
 adxl345_orientation ADXL345_WE::getOrientation(){
     adxl345_orientation orientation = FLAT;
-    getAngles();
+    xyzFloat angleVal = getAngles();
     if(abs(angleVal.x) < 45){      // |x| < 45
         if(abs(angleVal.y) < 45){      // |y| < 45
             if(angleVal.z > 0){          //  z  > 0
@@ -306,6 +446,7 @@ adxl345_orientation ADXL345_WE::getOrientation(){
     return orientation;
 }
 
+#ifndef ADXL345_NO_STRINGS
 String ADXL345_WE::getOrientationAsString(){
     adxl345_orientation orientation = getOrientation();
     String orientationAsString = "";
@@ -319,23 +460,25 @@ String ADXL345_WE::getOrientationAsString(){
     }
     return orientationAsString;
 }
+#endif
 
 float ADXL345_WE::getPitch(){
-    getGValues();
+    xyzFloat gVal = getGValues();
     float pitch = (atan2(gVal.x, sqrt(gVal.x*gVal.y + gVal.z*gVal.z))*180.0)/M_PI;
     return pitch;
 }
     
 float ADXL345_WE::getRoll(){
-    getGValues();
+    xyzFloat gVal = getGValues();
     float roll = (atan2(gVal.y, gVal.z)*180.0)/M_PI;
     return roll;
 }
+#endif // ADXL345_NO_ANGLES
 
 /************ Power, Sleep, Standby ************/ 
 
 void ADXL345_WE::setMeasureMode(bool measure){
-    regVal = readRegister8(ADXL345_POWER_CTL);
+    uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
     if(measure){
         regVal |= (1<<ADXL345_MEASURE);
     }
@@ -346,7 +489,7 @@ void ADXL345_WE::setMeasureMode(bool measure){
 }
 
 void ADXL345_WE::setSleep(bool sleep, adxl345_wUpFreq freq){
-    regVal = readRegister8(ADXL345_POWER_CTL);
+    uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
     regVal &= 0b11111100;
     regVal |= freq;
     if(sleep){
@@ -364,7 +507,7 @@ void ADXL345_WE::setSleep(bool sleep, adxl345_wUpFreq freq){
 }
 
 void ADXL345_WE::setSleep(bool sleep){
-    regVal = readRegister8(ADXL345_POWER_CTL);
+    uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
     if(sleep){
         regVal |= (1<<ADXL345_SLEEP);
     }
@@ -383,7 +526,7 @@ void ADXL345_WE::setAutoSleep(bool autoSleep, adxl345_wUpFreq freq){
     if(autoSleep){
         setLinkBit(true);
     }
-    regVal = readRegister8(ADXL345_POWER_CTL);
+    uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
     regVal &= 0b11111100;
     regVal |= freq;
     if(autoSleep){
@@ -398,12 +541,12 @@ void ADXL345_WE::setAutoSleep(bool autoSleep, adxl345_wUpFreq freq){
 void ADXL345_WE::setAutoSleep(bool autoSleep){
     if(autoSleep){
         setLinkBit(true);
-        regVal = readRegister8(ADXL345_POWER_CTL);
+        uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
         regVal |= (1<<ADXL345_AUTO_SLEEP);
         writeRegister(ADXL345_POWER_CTL, regVal);
     }
     else{
-        regVal = readRegister8(ADXL345_POWER_CTL);
+        uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
         regVal &= ~(1<<ADXL345_AUTO_SLEEP);
         writeRegister(ADXL345_POWER_CTL, regVal);
     }
@@ -415,7 +558,7 @@ bool ADXL345_WE::isAsleep(){
 }
 
 void ADXL345_WE::setLowPower(bool lowpwr){
-    regVal = readRegister8(ADXL345_BW_RATE);
+    uint8_t regVal = readRegister8(ADXL345_BW_RATE);
     if(lowpwr){
         regVal |= (1<<ADXL345_LOW_POWER);
     }
@@ -429,7 +572,7 @@ void ADXL345_WE::setLowPower(bool lowpwr){
 
 
 void ADXL345_WE::setInterrupt(adxl345_int type, uint8_t pin){
-    regVal = readRegister8(ADXL345_INT_ENABLE);
+    uint8_t regVal = readRegister8(ADXL345_INT_ENABLE);
     regVal |= (1<<type);
     writeRegister(ADXL345_INT_ENABLE, regVal);
     regVal = readRegister8(ADXL345_INT_MAP);
@@ -443,7 +586,7 @@ void ADXL345_WE::setInterrupt(adxl345_int type, uint8_t pin){
 }
 
 void ADXL345_WE::setInterruptPolarity(uint8_t pol){
-    regVal = readRegister8(ADXL345_DATA_FORMAT);
+    uint8_t regVal = readRegister8(ADXL345_DATA_FORMAT);
     if(pol == ADXL345_ACT_HIGH){
         regVal &= ~(0b00100000);
     }
@@ -453,14 +596,13 @@ void ADXL345_WE::setInterruptPolarity(uint8_t pol){
 };
 
 void ADXL345_WE::deleteInterrupt(adxl345_int type){
-    regVal = readRegister8(ADXL345_INT_ENABLE);
+    uint8_t regVal = readRegister8(ADXL345_INT_ENABLE);
     regVal &= ~(1<<type);
     writeRegister(ADXL345_INT_ENABLE, regVal);  
 }
 
 uint8_t ADXL345_WE::readAndClearInterrupts(){
-    regVal = readRegister8(ADXL345_INT_SOURCE);
-    return regVal;
+    return readRegister8(ADXL345_INT_SOURCE);
 }
 
 bool ADXL345_WE::checkInterrupt(uint8_t source, adxl345_int type){
@@ -468,7 +610,7 @@ bool ADXL345_WE::checkInterrupt(uint8_t source, adxl345_int type){
     return source;
 }
 void ADXL345_WE::setLinkBit(bool link){
-    regVal = readRegister8(ADXL345_POWER_CTL);
+    uint8_t regVal = readRegister8(ADXL345_POWER_CTL);
     if(link){
         regVal |= (1<<ADXL345_LINK);
     }
@@ -479,7 +621,7 @@ void ADXL345_WE::setLinkBit(bool link){
 }
 
 void ADXL345_WE::setFreeFallThresholds(float ffg, float fft){
-    regVal = (uint8_t)(round(ffg / 0.0625));
+    uint8_t regVal = (uint8_t)(round(ffg / 0.0625));
     if(regVal<1){
         regVal = 1;
     }
@@ -492,7 +634,7 @@ void ADXL345_WE::setFreeFallThresholds(float ffg, float fft){
 }
 
 void ADXL345_WE::setActivityParameters(adxl345_dcAcMode mode, adxl345_actTapSet axes, float threshold){
-    regVal = (uint8_t)(round(threshold / 0.0625));
+    uint8_t regVal = (uint8_t)(round(threshold / 0.0625));
     if(regVal<1){
         regVal = 1;
     }
@@ -506,7 +648,7 @@ void ADXL345_WE::setActivityParameters(adxl345_dcAcMode mode, adxl345_actTapSet
 }
 
 void ADXL345_WE::setInactivityParameters(adxl345_dcAcMode mode, adxl345_actTapSet axes, float threshold, uint8_t inactTime){
-    regVal = (uint8_t)(round(threshold / 0.0625));
+    uint8_t regVal = (uint8_t)(round(threshold / 0.0625));
     if(regVal<1){
         regVal = 1;
     }
@@ -521,7 +663,7 @@ void ADXL345_WE::setInactivityParameters(adxl345_dcAcMode mode, adxl345_actTapSe
 }
 
 void ADXL345_WE::setGeneralTapParameters(adxl345_actTapSet axes, float threshold, float duration, float latent){
-    regVal = readRegister8(ADXL345_TAP_AXES);
+    uint8_t regVal = readRegister8(ADXL345_TAP_AXES);
     regVal &= 0b11111000;
     regVal |= uint8_t(axes);
     writeRegister(ADXL345_TAP_AXES, regVal);
@@ -546,7 +688,7 @@ void ADXL345_WE::setGeneralTapParameters(adxl345_actTapSet axes, float threshold
 }
 
 void ADXL345_WE::setAdditionalDoubleTapParameters(bool suppress, float window){
-    regVal = readRegister8(ADXL345_TAP_AXES);
+    uint8_t regVal = readRegister8(ADXL345_TAP_AXES);
     if(suppress){
         regVal |= (1<<ADXL345_SUPPRESS);
     }
@@ -563,12 +705,13 @@ uint8_t ADXL345_WE::getActTapStatus(){
     return readRegister8(ADXL345_ACT_TAP_STATUS);
 }
 
+#ifndef ADXL345_NO_STRINGS
 String ADXL345_WE::getActTapStatusAsString(){
     uint8_t mask = (readRegister8(ADXL345_ACT_INACT_CTL)) & 0b01110000;
     mask |= ((readRegister8(ADXL345_TAP_AXES)) & 0b00000111);
         
     String returnStr = "";
-    regVal = readRegister8(ADXL345_ACT_TAP_STATUS); 
+    uint8_t regVal = readRegister8(ADXL345_ACT_TAP_STATUS); 
     regVal &= mask;
         
     if(regVal & (1<<ADXL345_TAP_Z)) { returnStr += "TAP-Z "; }
@@ -580,11 +723,38 @@ String ADXL345_WE::getActTapStatusAsString(){
     
     return returnStr;
 }
+#endif
+
+#ifdef ADXL345_USE_INT_HANDLERS
+/* Registers a handler for an interrupt type. Pass NULL to remove it. The context is passed to the 
+   handler unchanged, so one handler can serve several sensors. */
+void ADXL345_WE::setInterruptHandler(adxl345_int type, adxl345_intHandler handler, void *context){
+    intHandler[type] = handler;
+    intContext[type] = context;
+}
+
+/* Reads ACT_TAP_STATUS to INT_SOURCE (0x2B - 0x30) in one burst, which also clears the interrupts, 
+   and calls the handler of every pending interrupt. Returns the content of INT_SOURCE. */
+uint8_t ADXL345_WE::dispatchInterrupts(){
+    uint8_t buf[6] = {0, 0, 0, 0, 0, 0};
+    if(!readMultipleRegisters(ADXL345_ACT_TAP_STATUS, buf, 6)){
+        return 0;
+    }
+    uint8_t actTapStatus = buf[0];
+    uint8_t intSource = buf[5];
+    for(uint8_t i=0; i<8; i++){
+        if((intSource & (1<<i)) && intHandler[i]){
+            intHandler[i](intSource, actTapStatus, intContext[i]);
+        }
+    }
+    return intSource;
+}
+#endif
 
 /************ FIFO ************/
 
 void ADXL345_WE::setFifoParameters(adxl345_triggerInt intNumber, uint8_t samples){
-    regVal = readRegister8(ADXL345_FIFO_CTL);
+    uint8_t regVal = readRegister8(ADXL345_FIFO_CTL);
 	regVal &= 0b11000000;
     regVal |= (samples-1);
     if(intNumber == ADXL345_TRIGGER_INT_2){
@@ -594,7 +764,7 @@ void ADXL345_WE::setFifoParameters(adxl345_triggerInt intNumber, uint8_t samples
 }
 
 void ADXL345_WE::setFifoMode(adxl345_fifoMode mode){
-    regVal = readRegister8(ADXL345_FIFO_CTL);
+    uint8_t regVal = readRegister8(ADXL345_FIFO_CTL);
     regVal &= 0b00111111;
     regVal |= (mode<<6);
     writeRegister(ADXL345_FIFO_CTL,regVal);
@@ -604,16 +774,166 @@ uint8_t ADXL345_WE::getFifoStatus(){
     return readRegister8(ADXL345_FIFO_STATUS);
 }
 
+uint8_t ADXL345_WE::getFifoEntries(){
+    return readRegister8(ADXL345_FIFO_STATUS) & 0x3F;
+}
+
+/* To be called after INT1 or INT2 fired. Reads (and thereby clears) INT_SOURCE and, if a watermark, 
+   data ready or overrun interrupt is pending, reads the available FIFO entries into rawXYZ. 
+   If intSource is not NULL, the content of INT_SOURCE is passed back. Returns the number of 
+   x,y,z triples read. */
+uint8_t ADXL345_WE::drainFifo(int16_t *rawXYZ, uint8_t maxSamples, uint8_t *intSource){
+    uint8_t source = readAndClearInterrupts();
+    if(intSource){
+        *intSource = source;
+    }
+    if(!(source & ((1<<ADXL345_WATERMARK) | (1<<ADXL345_DATA_READY) | (1<<ADXL345_OVERRUN)))){
+        return 0;
+    }
+    uint8_t entries = getFifoEntries();
+    if((entries == 0) && (source & (1<<ADXL345_DATA_READY))){   // bypass mode: only the data registers hold a sample
+        entries = 1;
+    }
+    if(entries > maxSamples){
+        entries = maxSamples;
+    }
+    return getFifoRawValues(rawXYZ, entries);
+}
+
 void ADXL345_WE::resetTrigger(){
     setFifoMode(ADXL345_BYPASS);
     setFifoMode(ADXL345_TRIGGER);
 }
 
 
+/************ Configuration profile ************/
+
+/* Reads the registers and takes the calibration data. INT_SOURCE is not read, so pending interrupts
+   are not cleared. Returns false (and leaves the profile invalid) if the registers can't be read. */
+bool ADXL345_WE::getConfigProfile(adxl345_profile *profile){
+    memset(profile, 0, sizeof(adxl345_profile));  // defined padding bytes for the CRC
+    if(!readProfileRegisters(profile->reg)){
+        return false;
+    }
+    profile->fifoCtl = readRegister8(ADXL345_FIFO_CTL);
+    profile->offsetVal = offsetVal;
+    profile->corrFact = corrFact;
+#ifndef ADXL345_NO_ANGLES
+    profile->angleOffsetVal = angleOffsetVal;
+#else
+    profile->angleOffsetVal.x = 0.0;
+    profile->angleOffsetVal.y = 0.0;
+    profile->angleOffsetVal.z = 0.0;
+#endif
+    profile->version = ADXL345_PROFILE_VERSION;
+    profile->crc = profileCrc(profile);
+    return true;
+}
+
+/* Alternative to init() for a warm start. If the device registers already match the profile, 
+   only the calibration data are taken over. Otherwise the ADXL345 is set to standby and the 
+   registers are written: 0x1D - 0x2A in one burst, DATA_FORMAT, FIFO_CTL, BW_RATE, INT_MAP before
+   INT_ENABLE, and POWER_CTL alone and last. Returns false if the profile is invalid or the check 
+   fails. Profiles with another version or a wrong CRC are rejected before anything is changed. */
+bool ADXL345_WE::restoreConfigProfile(const adxl345_profile *profile){
+    if((profile->version != ADXL345_PROFILE_VERSION) || (profile->crc != profileCrc(profile))){
+        return false;
+    }
+    beginSPI();
+    offsetVal = profile->offsetVal;
+    corrFact = profile->corrFact;
+#ifndef ADXL345_NO_ANGLES
+    angleOffsetVal = profile->angleOffsetVal;
+#endif
+    uint8_t dataFormat = profile->reg[ADXL345_DATA_FORMAT - ADXL345_PROFILE_FIRST_REG];
+    adxl345_lowRes = !(dataFormat & (1<<ADXL345_FULL_RES));
+    rangeFactor = adxl345_lowRes ? (1 << (dataFormat & 0x03)) : 1;
+    
+    if(profileMatches(profile)){
+        return true;
+    }
+    writeRegister(ADXL345_POWER_CTL, 0);
+    writeMultipleRegisters(ADXL345_THRESH_TAP, profile->reg, ADXL345_ACT_TAP_STATUS - ADXL345_THRESH_TAP);
+    writeRegister(ADXL345_DATA_FORMAT, dataFormat);
+    writeRegister(ADXL345_FIFO_CTL, profile->fifoCtl);
+    writeRegister(ADXL345_BW_RATE, profile->reg[ADXL345_BW_RATE - ADXL345_PROFILE_FIRST_REG]);
+    writeRegister(ADXL345_INT_MAP, profile->reg[ADXL345_INT_MAP - ADXL345_PROFILE_FIRST_REG]);
+    writeRegister(ADXL345_INT_ENABLE, profile->reg[ADXL345_INT_ENABLE - ADXL345_PROFILE_FIRST_REG]);
+    readAndClearInterrupts();
+    writeRegister(ADXL345_POWER_CTL, profile->reg[ADXL345_POWER_CTL - ADXL345_PROFILE_FIRST_REG]);
+    
+    return profileMatches(profile);
+}
+
 /************************************************ 
     private functions
 *************************************************/
 
+void ADXL345_WE::beginSPI(){
+    if(useSPI){
+        _spi->begin();
+        pinMode(csPin, OUTPUT);
+        digitalWrite(csPin, HIGH);
+    }
+}
+
+/* Reads THRESH_TAP to INT_MAP in one burst and DATA_FORMAT separately. INT_SOURCE is skipped 
+   (set to 0), because reading it clears the interrupts. */
+bool ADXL345_WE::readProfileRegisters(uint8_t *reg){
+    if(!readMultipleRegisters(ADXL345_PROFILE_FIRST_REG, reg, ADXL345_INT_SOURCE - ADXL345_PROFILE_FIRST_REG)){
+        return false;
+    }
+    reg[ADXL345_INT_SOURCE - ADXL345_PROFILE_FIRST_REG] = 0;
+    reg[ADXL345_DATA_FORMAT - ADXL345_PROFILE_FIRST_REG] = readRegister8(ADXL345_DATA_FORMAT);
+    return true;
+}
+
+/* CRC8 (polynomial 0x07) of all bytes before the crc field */
+uint8_t ADXL345_WE::profileCrc(const adxl345_profile *profile){
+    const uint8_t *data = (const uint8_t*)profile;
+    uint8_t crc = 0;
+    for(size_t i=0; i<offsetof(adxl345_profile, crc); i++){
+        crc ^= data[i];
+        for(uint8_t bit=0; bit<8; bit++){
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool ADXL345_WE::profileMatches(const adxl345_profile *profile){
+    uint8_t reg[ADXL345_PROFILE_NO_OF_REGS];
+    if(!readProfileRegisters(reg)){
+        return false;
+    }
+    for(uint8_t i=0; i<ADXL345_PROFILE_NO_OF_REGS; i++){
+        uint8_t regAddr = ADXL345_PROFILE_FIRST_REG + i;
+        if((regAddr == ADXL345_ACT_TAP_STATUS) || (regAddr == ADXL345_INT_SOURCE)){
+            continue;
+        }
+        if(reg[i] != profile->reg[i]){
+            return false;
+        }
+    }
+    return readRegister8(ADXL345_FIFO_CTL) == profile->fifoCtl;
+}
+
+#ifdef ADXL345_USE_LATEST_SAMPLE
+void ADXL345_WE::readLatestSample(int16_t *rawXYZ, float *gXYZ){
+    uint8_t seqStart, seqEnd;
+    do{
+        seqStart = latestSeq;
+        adxl345_memoryBarrier();
+        for(uint8_t i=0; i<3; i++){
+            rawXYZ[i] = latestRaw[i];
+            gXYZ[i] = latestG[i];
+        }
+        adxl345_memoryBarrier();
+        seqEnd = latestSeq;
+    } while((seqStart != seqEnd) || (seqStart & 1));
+}
+#endif
+
 uint8_t ADXL345_WE::writeRegister(uint8_t reg, uint8_t val){
     if(!useSPI){
         _wire->beginTransmission(i2cAddress);
@@ -623,10 +943,12 @@ uint8_t ADXL345_WE::writeRegister(uint8_t reg, uint8_t val){
         return _wire->endTransmission();
     }
     else{
+        uint8_t buf[2] = {reg, val};
+        _spi->beginTransaction(mySPISettings);
         digitalWrite(csPin, LOW);
-        _spi->transfer(reg); 
-        _spi->transfer(val);
+        _spi->transfer(buf, 2);
         digitalWrite(csPin, HIGH);
+        _spi->endTransaction();
         return false; // to be amended
     }
 }
@@ -637,83 +959,86 @@ uint8_t ADXL345_WE::readRegister8(uint8_t reg){
         _wire->beginTransmission(i2cAddress);
         _wire->write(reg);
         _wire->endTransmission(false);
-        _wire->requestFrom(i2cAddress,1);
+        _wire->requestFrom(i2cAddress, (uint8_t)1);
         if(_wire->available()){
             regValue = _wire->read();
         }
     }
     else{
-        reg |= 0x80;
+        uint8_t buf[2] = {(uint8_t)(reg | 0x80), 0x00};
+        _spi->beginTransaction(mySPISettings);
         digitalWrite(csPin, LOW);
-        _spi->transfer(reg); 
-        regValue = _spi->transfer(0x00);
+        _spi->transfer(buf, 2);
         digitalWrite(csPin, HIGH);
+        _spi->endTransaction();
+        regValue = buf[1];
     }
     return regValue;
 }
 
 
-int16_t ADXL345_WE::readRegister16(uint8_t reg){
-    uint8_t MSByte = 0, LSByte = 0;
-    int16_t regValue = 0;
+/* Reads three 16 bit values (low byte first) into xyz. Returns false if the read fails. */
+bool ADXL345_WE::readRegister3x16(uint8_t reg, int16_t *xyz){    
+    uint8_t buf[6];
+    if(!readMultipleRegisters(reg, buf, 6)){
+        return false;
+    }
+    xyz[0] = (int16_t)(((uint16_t)buf[1] << 8) | buf[0]);
+    xyz[1] = (int16_t)(((uint16_t)buf[3] << 8) | buf[2]);
+    xyz[2] = (int16_t)(((uint16_t)buf[5] << 8) | buf[4]);
+    return true;
+}
+
+/* Burst write of 'count' (max. 31) consecutive registers starting at 'reg' */
+uint8_t ADXL345_WE::writeMultipleRegisters(uint8_t reg, const uint8_t *buf, uint8_t count){
     if(!useSPI){
         _wire->beginTransmission(i2cAddress);
         _wire->write(reg);
-        _wire->endTransmission(false);
-        _wire->requestFrom(i2cAddress,2);
-        if(_wire->available()){
-            LSByte = _wire->read();
-            MSByte = _wire->read();
-        }
+        _wire->write(buf, count);
+        return _wire->endTransmission();
     }
     else{
-        reg = reg | 0x80;
-        reg = reg | 0x40;
+        uint8_t spiBuf[32];
+        spiBuf[0] = reg | 0x40;
+        for(uint8_t i=0; i<count; i++){
+            spiBuf[i+1] = buf[i];
+        }
+        _spi->beginTransaction(mySPISettings);
         digitalWrite(csPin, LOW);
-        _spi->transfer(reg); 
-        LSByte = _spi->transfer(0x00);
-        MSByte = _spi->transfer(0x00);
+        _spi->transfer(spiBuf, count + 1);
         digitalWrite(csPin, HIGH);
+        _spi->endTransaction();
+        return false; // to be amended
     }
-    regValue = (MSByte<<8) + LSByte;    
-    return regValue;
 }
 
-uint64_t ADXL345_WE::readRegister3x16(uint8_t reg){    
-    uint8_t byte0 = 0, byte1 = 0, byte2 = 0, byte3 = 0, byte4 = 0, byte5 = 0;
-    uint64_t regValue = 0;
+/* Burst read of 'count' consecutive registers starting at 'reg'. Returns false (and leaves buf 
+   untouched) if the I2C device delivers fewer bytes than requested. */
+bool ADXL345_WE::readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count){
     if(!useSPI){
         _wire->beginTransmission(i2cAddress);
         _wire->write(reg);
         _wire->endTransmission(false);
-        _wire->requestFrom(i2cAddress,6);
-        if(_wire->available()){
-            byte0 = _wire->read();
-            byte1 = _wire->read();
-            byte2 = _wire->read();
-            byte3 = _wire->read();
-            byte4 = _wire->read();
-            byte5 = _wire->read();
+        if(_wire->requestFrom(i2cAddress, count) != count){
+            while(_wire->available()){
+                _wire->read();
+            }
+            return false;
+        }
+        for(uint8_t i=0; i<count; i++){
+            buf[i] = _wire->read();
         }
     }
     else{
-        reg = reg | 0x80;
-        reg = reg | 0x40;
+        _spi->beginTransaction(mySPISettings);
         digitalWrite(csPin, LOW);
-        _spi->transfer(reg); 
-        byte0 = _spi->transfer(0x00);
-        byte1 = _spi->transfer(0x00);
-        byte2 = _spi->transfer(0x00);
-        byte3 = _spi->transfer(0x00);
-        byte4 = _spi->transfer(0x00);
-        byte5 = _spi->transfer(0x00);
+        _spi->transfer((uint8_t)(reg | 0x80 | 0x40));
+        for(uint8_t i=0; i<count; i++){
+            buf[i] = 0x00;
+        }
+        _spi->transfer(buf, count);
         digitalWrite(csPin, HIGH);
+        _spi->endTransaction();
     }
-        
-    regValue = ((uint64_t) byte1<<40) + ((uint64_t) byte0<<32) +((uint64_t) byte3<<24) + 
-           + ((uint64_t) byte2<<16) + ((uint64_t) byte5<<8) +  (uint64_t)byte4;
-    return regValue;
+    return true;
 }
-
-
-
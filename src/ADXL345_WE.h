@@ -28,6 +28,20 @@
 #include <Wire.h>
 #include <SPI.h>
 
+/* Feature selection: uncomment (or define as build flag) to leave out functions you don't need.
+   ADXL345_NO_ANGLES:  no angles, pitch, roll and orientation (saves 12 bytes RAM per object)
+   ADXL345_NO_STRINGS: no ...AsString() functions (no String class needed) */
+// #define ADXL345_NO_ANGLES
+// #define ADXL345_NO_STRINGS
+
+/* Optional features: uncomment (or define as build flag) to add functions.
+   ADXL345_USE_INT_HANDLERS: interrupt dispatcher (costs 8 handler + 8 context pointers per object,
+                             32 bytes RAM on AVR)
+   ADXL345_USE_LATEST_SAMPLE: latest sample slot for concurrent readers (costs 19 bytes RAM per object:
+                              sequence counter, raw and g values) */
+// #define ADXL345_USE_INT_HANDLERS
+// #define ADXL345_USE_LATEST_SAMPLE
+
 /* registers */
 #define ADXL345_ADDRESS          0x53
 #define ADXL345_DEVID            0x00
@@ -73,6 +87,7 @@
 #define INT_PIN_2                   2
 #define ADXL345_ACT_LOW             1
 #define ADXL345_ACT_HIGH            0
+#define ADXL345_MAX_SPI_CLOCK 5000000
 
 
 typedef enum ADXL345_PWR_CTL {
@@ -148,12 +163,32 @@ typedef enum ADXL345_TRIGGER_INT {
     ADXL345_TRIGGER_INT_1, ADXL345_TRIGGER_INT_2
 } adxl345_triggerInt;
 
+/* Interrupt handler: intSource = INT_SOURCE, actTapStatus = ACT_TAP_STATUS (bits see adxl345_actTap),
+   context = pointer passed to setInterruptHandler() (e.g. the ADXL345_WE object or your own data) */
+typedef void (*adxl345_intHandler)(uint8_t intSource, uint8_t actTapStatus, void *context);
+
 struct xyzFloat {
     float x;
     float y;
     float z;
 };
 
+/* Complete configuration incl. calibration, e.g. to be stored in EEPROM. The CRC8 covers all
+   bytes before it, so that stale or partly written profiles are rejected. */
+#define ADXL345_PROFILE_VERSION     2
+#define ADXL345_PROFILE_FIRST_REG   ADXL345_THRESH_TAP
+#define ADXL345_PROFILE_NO_OF_REGS  21   // THRESH_TAP (0x1D) to DATA_FORMAT (0x31)
+
+struct adxl345_profile {
+    uint8_t version;
+    uint8_t reg[ADXL345_PROFILE_NO_OF_REGS];  // ACT_TAP_STATUS and INT_SOURCE are read-only and ignored
+    uint8_t fifoCtl;
+    xyzFloat offsetVal;
+    xyzFloat corrFact;
+    xyzFloat angleOffsetVal;
+    uint8_t crc;
+};
+
 
 class ADXL345_WE
 {
@@ -170,31 +205,53 @@ public:
     /* Basic settings */
     
     bool init();
+    void setSPIClockSpeed(unsigned long clock);
+    void setI2CClockSpeed(unsigned long clock);
     void setCorrFactors(float xMin, float xMax, float yMin, float yMax, float zMin, float zMax);
     void setDataRate(adxl345_dataRate rate);
     adxl345_dataRate getDataRate();
+#ifndef ADXL345_NO_STRINGS
     String getDataRateAsString();
+#endif
     uint8_t getPowerCtlReg();
     void setRange(adxl345_range range);
     adxl345_range getRange();
     void setFullRes(boolean full);
+#ifndef ADXL345_NO_STRINGS
     String getRangeAsString();
+#endif
     
     /* x,y,z results */
         
     xyzFloat getRawValues();
     xyzFloat getCorrectedRawValues();
     xyzFloat getGValues();
+#ifndef ADXL345_NO_ANGLES
     xyzFloat getAngles();
     xyzFloat getCorrAngles();
+#endif
+    uint8_t getFifoRawValues(int16_t *rawXYZ, uint8_t samples);
+    void convertRawToGValues(const int16_t *rawXYZ, float *gx, float *gy, float *gz, uint16_t samples);
+    xyzFloat getRawPerG();
+    xyzFloat getRawOffsets();
+#ifdef ADXL345_USE_LATEST_SAMPLE
+    bool updateLatestSample();
+    void updateLatestSample(const int16_t *rawXYZ);
+    xyzFloat getLatestRawValues();
+    xyzFloat getLatestGValues();
+#endif
         
     /* Angles and Orientation */ 
     
+#ifndef ADXL345_NO_ANGLES
     void measureAngleOffsets();
     adxl345_orientation getOrientation();
+#ifndef ADXL345_NO_STRINGS
     String getOrientationAsString();
+#endif
     float getPitch();
     float getRoll();
+#endif
     
     /* Power, Sleep, Standby */ 
     
@@ -220,34 +277,64 @@ public:
     void setGeneralTapParameters(adxl345_actTapSet axes, float threshold, float duration, float latent);
     void setAdditionalDoubleTapParameters(bool suppress, float window);
     uint8_t getActTapStatus();
+#ifndef ADXL345_NO_STRINGS
     String getActTapStatusAsString();
+#endif
+#ifdef ADXL345_USE_INT_HANDLERS
+    void setInterruptHandler(adxl345_int type, adxl345_intHandler handler, void *context = NULL);
+    uint8_t dispatchInterrupts();
+#endif
     
     /* FIFO */
     
     void setFifoParameters(adxl345_triggerInt intNumber, uint8_t samples);
     void setFifoMode(adxl345_fifoMode mode);
     uint8_t getFifoStatus();
+    uint8_t getFifoEntries();
+    uint8_t drainFifo(int16_t *rawXYZ, uint8_t maxSamples, uint8_t *intSource);
     void resetTrigger();
     
+    /* Configuration profile */
+    
+    bool getConfigProfile(adxl345_profile *profile);
+    bool restoreConfigProfile(const adxl345_profile *profile);
+    
+    
+protected:
+    /* The register access is virtual, so derived classes can record or replay the bus traffic */
+    virtual uint8_t writeRegister(uint8_t reg, uint8_t val);
+    virtual uint8_t readRegister8(uint8_t reg);
+    virtual bool readMultipleRegisters(uint8_t reg, uint8_t *buf, uint8_t count);
+    virtual uint8_t writeMultipleRegisters(uint8_t reg, const uint8_t *buf, uint8_t count);
     
 private:
     TwoWire *_wire;
     SPIClass *_spi;
-    int i2cAddress;
-    uint8_t regVal;   // intermediate storage of register values
-    xyzFloat rawVal;
-    xyzFloat gVal;
-    xyzFloat angleVal;
+    SPISettings mySPISettings;
+    uint8_t i2cAddress;
     xyzFloat offsetVal;
+#ifndef ADXL345_NO_ANGLES
     xyzFloat angleOffsetVal;
+#endif
     xyzFloat corrFact;
-    int csPin;
+    uint8_t csPin;
     bool useSPI;
-    int16_t rangeFactor;
-    uint8_t writeRegister(uint8_t reg, uint8_t val);
-    uint8_t readRegister8(uint8_t reg);
-    int16_t readRegister16(uint8_t reg);
-    uint64_t readRegister3x16(uint8_t reg);
+    uint8_t rangeFactor;
+#ifdef ADXL345_USE_INT_HANDLERS
+    adxl345_intHandler intHandler[8] = {};
+    void *intContext[8] = {};
+#endif
+#ifdef ADXL345_USE_LATEST_SAMPLE
+    volatile uint8_t latestSeq = 0;   // odd while the latest sample is being updated
+    volatile int16_t latestRaw[3] = {};
+    volatile float latestG[3] = {};
+    void readLatestSample(int16_t *rawXYZ, float *gXYZ);
+#endif
+    bool readRegister3x16(uint8_t reg, int16_t *xyz);
+    void beginSPI();
+    bool readProfileRegisters(uint8_t *reg);
+    bool profileMatches(const adxl345_profile *profile);
+    uint8_t profileCrc(const adxl345_profile *profile);
     bool adxl345_lowRes;
 };
 